@@ -1,5 +1,10 @@
 #pragma once
 
+// Calling convention only exists on windows
+#if !defined(_WIN32) && !defined(__stdcall)
+#define __stdcall
+#endif
+
 namespace carousel
 {
 	namespace callbacks
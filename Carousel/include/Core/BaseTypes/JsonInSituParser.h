@@ -0,0 +1,309 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <functional>
+#include <stdexcept>
+
+namespace carousel
+{
+	namespace core
+	{
+		/// <summary>
+		/// Parses flat JSON objects, or an array of flat objects, in place. String escapes are decoded
+		/// inside the input buffer and values are handed out as views into it, nothing is copied.
+		/// Member values are strings, numbers or booleans (passed as written), null members are skipped.
+		/// </summary>
+		class JsonInSituParser
+		{
+		public:
+			/// <summary>
+			/// Called for each member (name, value), views are valid while the buffer is valid
+			/// </summary>
+			typedef std::function<void(std::string_view, std::string_view)> MemberCallback;
+
+			/// <summary>
+			/// Called after all members of an object were read
+			/// </summary>
+			typedef std::function<void()> ObjectCallback;
+
+		private:
+			/// <summary>
+			/// Current position
+			/// </summary>
+			char* _cursor;
+
+			/// <summary>
+			/// End of the buffer
+			/// </summary>
+			char* _end;
+
+			/// <summary>
+			/// Member callback
+			/// </summary>
+			MemberCallback _onMember;
+
+			/// <summary>
+			/// Object callback
+			/// </summary>
+			ObjectCallback _onObject;
+
+			/// <summary>
+			/// Number of objects read
+			/// </summary>
+			size_t _objectCount{ 0 };
+
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			/// <param name="begin">Start of the buffer, the buffer is modified while parsing</param>
+			/// <param name="end">End of the buffer</param>
+			/// <param name="onMember">Member callback</param>
+			/// <param name="onObject">Object callback</param>
+			JsonInSituParser(char* begin, char* end, MemberCallback onMember, ObjectCallback onObject = nullptr)
+				: _cursor(begin), _end(end), _onMember(std::move(onMember)), _onObject(std::move(onObject))
+			{
+				// Empty
+			}
+
+			/// <summary>
+			/// Parses buffer and returns the number of objects, throws std::runtime_error if
+			/// the buffer is not valid.
+			/// </summary>
+			size_t parse()
+			{
+				skipWhitespace();
+				if (peek() == '[')
+				{
+					_cursor++;
+					skipWhitespace();
+					if (peek() == ']')
+					{
+						_cursor++;
+					}
+					else
+					{
+						while (true)
+						{
+							parseObject();
+							skipWhitespace();
+
+							char separator = next();
+							if (separator == ']') break;
+							if (separator != ',') error("expected ',' or ']'");
+							skipWhitespace();
+						}
+					}
+				}
+				else
+				{
+					parseObject();
+				}
+
+				skipWhitespace();
+				if (_cursor != _end) error("unexpected data after end");
+
+				return _objectCount;
+			}
+
+		private:
+			/// <summary>
+			/// Parses object and reports its members
+			/// </summary>
+			void parseObject()
+			{
+				expect('{');
+				skipWhitespace();
+
+				if (peek() == '}')
+				{
+					_cursor++;
+				}
+				else
+				{
+					while (true)
+					{
+						skipWhitespace();
+						std::string_view name = parseString();
+						skipWhitespace();
+						expect(':');
+						skipWhitespace();
+						parseValue(name);
+						skipWhitespace();
+
+						char separator = next();
+						if (separator == '}') break;
+						if (separator != ',') error("expected ',' or '}'");
+					}
+				}
+
+				_objectCount++;
+				if (_onObject) _onObject();
+			}
+
+			/// <summary>
+			/// Parses member value
+			/// </summary>
+			void parseValue(std::string_view name)
+			{
+				char c = peek();
+				if (c == '"')
+				{
+					std::string_view value = parseString();
+					_onMember(name, value);
+					return;
+				}
+
+				if (c == '{' || c == '[') error("nested values are not supported");
+
+				// Number, boolean or null
+				char* start = _cursor;
+				while (_cursor < _end && *_cursor != ',' && *_cursor != '}' && *_cursor != ']' && !isWhitespace(*_cursor))
+				{
+					_cursor++;
+				}
+
+				std::string_view token(start, _cursor - start);
+				if (token == "null") return;
+				if (token.empty() || (token != "true" && token != "false" && token[0] != '-' && (token[0] < '0' || token[0] > '9')))
+				{
+					error("invalid value");
+				}
+
+				_onMember(name, token);
+			}
+
+			/// <summary>
+			/// Parses string, escapes are decoded in place
+			/// </summary>
+			std::string_view parseString()
+			{
+				expect('"');
+				char* start = _cursor;
+				char* output = _cursor;
+
+				while (true)
+				{
+					if (_cursor >= _end) error("unterminated string");
+
+					char c = *_cursor++;
+					if (c == '"') break;
+					if (c != '\\')
+					{
+						*output++ = c;
+						continue;
+					}
+
+					char escaped = next();
+					switch (escaped)
+					{
+					case '"': *output++ = '"'; break;
+					case '\\': *output++ = '\\'; break;
+					case '/': *output++ = '/'; break;
+					case 'n': *output++ = '\n'; break;
+					case 'r': *output++ = '\r'; break;
+					case 't': *output++ = '\t'; break;
+					case 'b': *output++ = '\b'; break;
+					case 'f': *output++ = '\f'; break;
+					case 'u': output = decodeUnicode(output); break;
+					default: error("invalid escape sequence");
+					}
+				}
+
+				return std::string_view(start, output - start);
+			}
+
+			/// <summary>
+			/// Decodes \uXXXX (and surrogate pairs) as UTF-8, the result is never longer than the
+			/// escape sequence
+			/// </summary>
+			char* decodeUnicode(char* output)
+			{
+				unsigned long codePoint = readHex();
+				if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+				{
+					if (next() != '\\' || next() != 'u') error("invalid surrogate pair");
+					unsigned long low = readHex();
+					if (low < 0xDC00 || low > 0xDFFF) error("invalid surrogate pair");
+					codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+				}
+
+				if (codePoint < 0x80)
+				{
+					*output++ = static_cast<char>(codePoint);
+				}
+				else if (codePoint < 0x800)
+				{
+					*output++ = static_cast<char>(0xC0 | (codePoint >> 6));
+					*output++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+				}
+				else if (codePoint < 0x10000)
+				{
+					*output++ = static_cast<char>(0xE0 | (codePoint >> 12));
+					*output++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+					*output++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+				}
+				else
+				{
+					*output++ = static_cast<char>(0xF0 | (codePoint >> 18));
+					*output++ = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+					*output++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+					*output++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+				}
+
+				return output;
+			}
+
+			/// <summary>
+			/// Reads four hex digits
+			/// </summary>
+			unsigned long readHex()
+			{
+				unsigned long value{ 0 };
+				for (int i = 0; i < 4; i++)
+				{
+					char c = next();
+					value <<= 4;
+					if (c >= '0' && c <= '9') value |= c - '0';
+					else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+					else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+					else error("invalid unicode escape");
+				}
+
+				return value;
+			}
+
+			static bool isWhitespace(char c)
+			{
+				return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+			}
+
+			void skipWhitespace()
+			{
+				while (_cursor < _end && isWhitespace(*_cursor)) _cursor++;
+			}
+
+			char peek() const
+			{
+				return _cursor < _end ? *_cursor : '\0';
+			}
+
+			char next()
+			{
+				if (_cursor >= _end) error("unexpected end");
+				return *_cursor++;
+			}
+
+			void expect(char c)
+			{
+				if (next() != c) error(std::string("expected '") + c + "'");
+			}
+
+			[[noreturn]] static void error(const std::string& message)
+			{
+				throw std::runtime_error("JsonInSituParser: " + message);
+			}
+		};
+	}
+}
\ No newline at end of file
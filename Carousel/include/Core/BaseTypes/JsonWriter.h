@@ -0,0 +1,135 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace carousel
+{
+	namespace core
+	{
+		/// <summary>
+		/// Appends JSON tokens to a string in a single pass, no intermediate document is built
+		/// </summary>
+		class JsonWriter
+		{
+		private:
+			/// <summary>
+			/// Output
+			/// </summary>
+			std::string& _output;
+
+			/// <summary>
+			/// True if the next member or element is the first of its container
+			/// </summary>
+			bool _isFirst{ true };
+
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			JsonWriter(std::string& output) : _output(output)
+			{
+				// Empty
+			}
+
+			/// <summary>
+			/// Opens object
+			/// </summary>
+			void beginObject()
+			{
+				separate();
+				_output += '{';
+				_isFirst = true;
+			}
+
+			/// <summary>
+			/// Closes object
+			/// </summary>
+			void endObject()
+			{
+				_output += '}';
+				_isFirst = false;
+			}
+
+			/// <summary>
+			/// Opens array
+			/// </summary>
+			void beginArray()
+			{
+				separate();
+				_output += '[';
+				_isFirst = true;
+			}
+
+			/// <summary>
+			/// Closes array
+			/// </summary>
+			void endArray()
+			{
+				_output += ']';
+				_isFirst = false;
+			}
+
+			/// <summary>
+			/// Writes object member with a string value
+			/// </summary>
+			void member(std::string_view name, std::string_view value)
+			{
+				separate();
+				appendString(name);
+				_output += ':';
+				appendString(value);
+			}
+
+		private:
+			/// <summary>
+			/// Adds separator between members or elements
+			/// </summary>
+			void separate()
+			{
+				if (!_isFirst) _output += ',';
+				_isFirst = false;
+			}
+
+			/// <summary>
+			/// Appends quoted and escaped string
+			/// </summary>
+			void appendString(std::string_view value)
+			{
+				static const char hexDigits[] = "0123456789abcdef";
+
+				_output += '"';
+
+				// Copy runs of characters that don't need escaping at once
+				size_t runStart{ 0 };
+				for (size_t i = 0; i < value.size(); i++)
+				{
+					unsigned char c = static_cast<unsigned char>(value[i]);
+					if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+					_output.append(value.data() + runStart, i - runStart);
+					runStart = i + 1;
+
+					switch (c)
+					{
+					case '"': _output += "\\\""; break;
+					case '\\': _output += "\\\\"; break;
+					case '\n': _output += "\\n"; break;
+					case '\r': _output += "\\r"; break;
+					case '\t': _output += "\\t"; break;
+					case '\b': _output += "\\b"; break;
+					case '\f': _output += "\\f"; break;
+					default:
+						_output += "\\u00";
+						_output += hexDigits[c >> 4];
+						_output += hexDigits[c & 0xF];
+						break;
+					}
+				}
+
+				_output.append(value.data() + runStart, value.size() - runStart);
+				_output += '"';
+			}
+		};
+	}
+}
\ No newline at end of file
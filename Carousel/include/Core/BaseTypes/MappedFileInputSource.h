@@ -0,0 +1,202 @@
+#pragma once
+
+#include <xercesc/sax/InputSource.hpp>
+#include <xercesc/util/BinMemInputStream.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
+#include <string>
+#include <memory>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace carousel
+{
+	namespace core
+	{
+		/// <summary>
+		/// Read only memory mapping of a file, unmapped on destruction
+		/// </summary>
+		class MappedFile
+		{
+		private:
+			/// <summary>
+			/// Mapped content, nullptr for empty files
+			/// </summary>
+			const char* _data{ nullptr };
+
+			/// <summary>
+			/// File size
+			/// </summary>
+			size_t _size{ 0 };
+
+#ifdef _WIN32
+			/// <summary>
+			/// File mapping handle
+			/// </summary>
+			HANDLE _mapping{ nullptr };
+#endif
+
+		public:
+			/// <summary>
+			/// Constructor, maps the whole file
+			/// </summary>
+			MappedFile(const std::string& filepath)
+			{
+#ifdef _WIN32
+				HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+				if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("MappedFile: could not open " + filepath);
+
+				LARGE_INTEGER fileSize;
+				if (!GetFileSizeEx(file, &fileSize))
+				{
+					CloseHandle(file);
+					throw std::runtime_error("MappedFile: could not read size of " + filepath);
+				}
+
+				_size = static_cast<size_t>(fileSize.QuadPart);
+				if (_size > 0)
+				{
+					_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+					if (_mapping != nullptr) _data = static_cast<const char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+				}
+				CloseHandle(file);
+
+				if (_size > 0 && _data == nullptr)
+				{
+					if (_mapping != nullptr) CloseHandle(_mapping);
+					throw std::runtime_error("MappedFile: could not map " + filepath);
+				}
+#else
+				int file = open(filepath.c_str(), O_RDONLY);
+				if (file < 0) throw std::runtime_error("MappedFile: could not open " + filepath);
+
+				struct stat fileStat;
+				if (fstat(file, &fileStat) != 0)
+				{
+					close(file);
+					throw std::runtime_error("MappedFile: could not read size of " + filepath);
+				}
+
+				_size = static_cast<size_t>(fileStat.st_size);
+				if (_size > 0)
+				{
+					void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file, 0);
+					if (data != MAP_FAILED)
+					{
+						// Parsers read front to back
+						madvise(data, _size, MADV_SEQUENTIAL);
+						_data = static_cast<const char*>(data);
+					}
+				}
+				close(file);
+
+				if (_size > 0 && _data == nullptr) throw std::runtime_error("MappedFile: could not map " + filepath);
+#endif
+			}
+
+			/// <summary>
+			/// Copy constructor (removed)
+			/// </summary>
+			MappedFile(const MappedFile&) = delete;
+
+			/// <summary>
+			/// Assignment operator (removed)
+			/// </summary>
+			void operator=(const MappedFile&) = delete;
+
+			/// <summary>
+			/// Destructor
+			/// </summary>
+			~MappedFile()
+			{
+				if (_data == nullptr) return;
+
+#ifdef _WIN32
+				UnmapViewOfFile(_data);
+				CloseHandle(_mapping);
+#else
+				munmap(const_cast<char*>(_data), _size);
+#endif
+			}
+
+			/// <summary>
+			/// Returns mapped content
+			/// </summary>
+			const char* data() const
+			{
+				return _data;
+			}
+
+			/// <summary>
+			/// Returns file size
+			/// </summary>
+			size_t size() const
+			{
+				return _size;
+			}
+		};
+
+		/// <summary>
+		/// Stream over a memory mapped file, keeps the mapping alive as long as the parser reads from it
+		/// </summary>
+		class MappedFileInputStream : public xercesc::BinMemInputStream
+		{
+		private:
+			/// <summary>
+			/// Mapped file, shared with the input source
+			/// </summary>
+			std::shared_ptr<MappedFile> _file;
+
+		public:
+			/// <summary>
+			/// Constructor, the content is referenced and not copied
+			/// </summary>
+			MappedFileInputStream(std::shared_ptr<MappedFile> file, xercesc::MemoryManager* manager)
+				: xercesc::BinMemInputStream(reinterpret_cast<const XMLByte*>(file->data()), file->size(), xercesc::BinMemInputStream::BufOpt_Reference, manager),
+				_file(std::move(file))
+			{
+				// Empty
+			}
+		};
+
+		/// <summary>
+		/// Xerces input source that reads directly from a memory mapped file. The parser reads the
+		/// page cache without copying the file into intermediate buffers. Can also be passed to the
+		/// xsd generated InputSource parse functions (e.g. carousel::data::CaseModel_(source)).
+		/// </summary>
+		class MappedFileInputSource : public xercesc::InputSource
+		{
+		private:
+			/// <summary>
+			/// Mapped file, shared with the streams created from this source
+			/// </summary>
+			std::shared_ptr<MappedFile> _file;
+
+		public:
+			/// <summary>
+			/// Constructor, maps the file. The file path is used as system id.
+			/// </summary>
+			MappedFileInputSource(const std::string& filepath, xercesc::MemoryManager* manager = xercesc::XMLPlatformUtils::fgMemoryManager)
+				: xercesc::InputSource(filepath.c_str(), manager), _file(std::make_shared<MappedFile>(filepath))
+			{
+				// Empty
+			}
+
+			/// <summary>
+			/// Creates stream over the mapped content, the content is referenced and not copied.
+			/// The stream keeps the mapping alive, it may outlive this source.
+			/// </summary>
+			xercesc::BinInputStream* makeStream() const override
+			{
+				return new (getMemoryManager()) MappedFileInputStream(_file, getMemoryManager());
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <xercesc/framework/XMLFormatter.hpp>
+#include <ostream>
+
+namespace carousel
+{
+	namespace core
+	{
+		/// <summary>
+		/// Xerces format target that writes serialized data directly into a std::ostream
+		/// </summary>
+		class OStreamFormatTarget : public xercesc::XMLFormatTarget
+		{
+		private:
+			/// <summary>
+			/// Output stream
+			/// </summary>
+			std::ostream& _stream;
+
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			OStreamFormatTarget(std::ostream& stream) : _stream(stream) { }
+
+		public: // XMLFormatTarget
+
+			void writeChars(const XMLByte* const toWrite, const XMLSize_t count, xercesc::XMLFormatter* const formatter) override
+			{
+				_stream.write(reinterpret_cast<const char*>(toWrite), static_cast<std::streamsize>(count));
+			}
+
+			void flush() override
+			{
+				_stream.flush();
+			}
+		};
+	}
+}
\ No newline at end of file
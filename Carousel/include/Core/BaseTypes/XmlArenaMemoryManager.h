@@ -0,0 +1,271 @@
+#pragma once
+
+#include <xercesc/framework/MemoryManager.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/OutOfMemoryException.hpp>
+#include <array>
+#include <new>
+#include <vector>
+
+namespace carousel
+{
+	namespace core
+	{
+		/// <summary>
+		/// Xerces memory manager backed by an arena. Small allocations are taken from size class pools
+		/// that are bump allocated from large blocks, freed allocations are reused by their size class.
+		/// All memory is returned at once when the manager is destroyed, a document that owns its manager
+		/// is freed without walking its nodes.
+		/// Note: Not thread safe, use one manager per document or parser. Different managers do not
+		///		  share any state, threads that load documents concurrently do not contend on the heap.
+		/// </summary>
+		class XmlArenaMemoryManager : public xercesc::MemoryManager
+		{
+		private:
+			/// <summary>
+			/// Header stored in front of each allocation, the size class is placed right before
+			/// the returned pointer. Keeps allocations aligned.
+			/// </summary>
+			static constexpr size_t HEADER_SIZE{ 16 };
+
+			/// <summary>
+			/// Header of allocations that are larger than the largest size class
+			/// </summary>
+			static constexpr size_t LARGE_HEADER_SIZE{ 32 };
+
+			/// <summary>
+			/// Smallest size class, size classes double up to MIN_CLASS_SIZE << (SIZE_CLASS_COUNT - 1)
+			/// </summary>
+			static constexpr size_t MIN_CLASS_SIZE{ 16 };
+
+			/// <summary>
+			/// Number of size classes (16 bytes to 4 KB)
+			/// </summary>
+			static constexpr size_t SIZE_CLASS_COUNT{ 9 };
+
+			/// <summary>
+			/// Size class of allocations that are not pooled
+			/// </summary>
+			static constexpr size_t LARGE_CLASS{ SIZE_CLASS_COUNT };
+
+			/// <summary>
+			/// Size of the blocks used for bump allocation
+			/// </summary>
+			static constexpr size_t BLOCK_SIZE{ 64 * 1024 };
+
+			/// <summary>
+			/// Released allocation in a size class pool
+			/// </summary>
+			struct FreeNode
+			{
+				FreeNode* next;
+			};
+
+			/// <summary>
+			/// Header of large allocations, large allocations are tracked in a list
+			/// </summary>
+			struct LargeAllocation
+			{
+				LargeAllocation* previous;
+				LargeAllocation* next;
+			};
+
+			/// <summary>
+			/// Blocks used for bump allocation
+			/// </summary>
+			std::vector<void*> _blocks;
+
+			/// <summary>
+			/// Next free byte in the current block
+			/// </summary>
+			char* _current{ nullptr };
+
+			/// <summary>
+			/// Remaining bytes in the current block
+			/// </summary>
+			size_t _remaining{ 0 };
+
+			/// <summary>
+			/// Released allocations of each size class
+			/// </summary>
+			std::array<FreeNode*, SIZE_CLASS_COUNT> _freeLists{};
+
+			/// <summary>
+			/// Large allocations that are still in use
+			/// </summary>
+			LargeAllocation* _largeAllocations{ nullptr };
+
+			/// <summary>
+			/// Bytes reserved for pooled allocations
+			/// </summary>
+			size_t _reservedSize{ 0 };
+
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			XmlArenaMemoryManager() = default;
+
+			/// <summary>
+			/// Copy constructor (removed)
+			/// </summary>
+			XmlArenaMemoryManager(const XmlArenaMemoryManager&) = delete;
+
+			/// <summary>
+			/// Assignment operator (removed)
+			/// </summary>
+			void operator=(const XmlArenaMemoryManager&) = delete;
+
+			/// <summary>
+			/// Destructor, releases all memory
+			/// </summary>
+			~XmlArenaMemoryManager() override
+			{
+				for (void* block : _blocks)
+				{
+					::operator delete(block);
+				}
+
+				while (_largeAllocations != nullptr)
+				{
+					LargeAllocation* next = _largeAllocations->next;
+					::operator delete(_largeAllocations);
+					_largeAllocations = next;
+				}
+			}
+
+		public: // MemoryManager
+
+			/// <summary>
+			/// Exceptions can outlive the arena, these use the global memory manager
+			/// </summary>
+			xercesc::MemoryManager* getExceptionMemoryManager() override
+			{
+				return xercesc::XMLPlatformUtils::fgMemoryManager;
+			}
+
+			void* allocate(XMLSize_t size) override
+			{
+				size_t sizeClass = getSizeClass(size);
+				if (sizeClass == LARGE_CLASS) return allocateLarge(size);
+
+				// Reuse released allocation
+				FreeNode* node = _freeLists[sizeClass];
+				if (node != nullptr)
+				{
+					_freeLists[sizeClass] = node->next;
+					return node;
+				}
+
+				// Bump allocate from current block
+				size_t chunkSize = HEADER_SIZE + (MIN_CLASS_SIZE << sizeClass);
+				if (_remaining < chunkSize)
+				{
+					_current = static_cast<char*>(allocateMemory(BLOCK_SIZE));
+					_blocks.push_back(_current);
+					_reservedSize += BLOCK_SIZE;
+					_remaining = BLOCK_SIZE;
+				}
+
+				char* result = _current + HEADER_SIZE;
+				_current += chunkSize;
+				_remaining -= chunkSize;
+
+				sizeClassOf(result) = sizeClass;
+				return result;
+			}
+
+			void deallocate(void* p) override
+			{
+				if (p == nullptr) return;
+
+				size_t sizeClass = sizeClassOf(p);
+				if (sizeClass == LARGE_CLASS)
+				{
+					deallocateLarge(p);
+					return;
+				}
+
+				FreeNode* node = static_cast<FreeNode*>(p);
+				node->next = _freeLists[sizeClass];
+				_freeLists[sizeClass] = node;
+			}
+
+		public:
+			/// <summary>
+			/// Returns the number of bytes reserved for pooled allocations
+			/// </summary>
+			size_t getReservedSize() const
+			{
+				return _reservedSize;
+			}
+
+		private:
+			/// <summary>
+			/// Returns the smallest size class that fits size, or LARGE_CLASS
+			/// </summary>
+			static size_t getSizeClass(size_t size)
+			{
+				size_t sizeClass{ 0 };
+				while (sizeClass < SIZE_CLASS_COUNT && (MIN_CLASS_SIZE << sizeClass) < size)
+				{
+					sizeClass++;
+				}
+
+				return sizeClass;
+			}
+
+			/// <summary>
+			/// Size class stored in the header of an allocation
+			/// </summary>
+			static size_t& sizeClassOf(void* p)
+			{
+				return *(reinterpret_cast<size_t*>(p) - 1);
+			}
+
+			/// <summary>
+			/// Allocates from the system, allocation failures are reported as xerces out of memory
+			/// </summary>
+			static void* allocateMemory(size_t size)
+			{
+				try
+				{
+					return ::operator new(size);
+				}
+				catch (const std::bad_alloc&)
+				{
+					throw xercesc::OutOfMemoryException();
+				}
+			}
+
+			/// <summary>
+			/// Allocations larger than the largest size class are tracked individually
+			/// </summary>
+			void* allocateLarge(size_t size)
+			{
+				LargeAllocation* allocation = static_cast<LargeAllocation*>(allocateMemory(LARGE_HEADER_SIZE + size));
+				allocation->previous = nullptr;
+				allocation->next = _largeAllocations;
+				if (_largeAllocations != nullptr) _largeAllocations->previous = allocation;
+				_largeAllocations = allocation;
+
+				char* result = reinterpret_cast<char*>(allocation) + LARGE_HEADER_SIZE;
+				sizeClassOf(result) = LARGE_CLASS;
+				return result;
+			}
+
+			/// <summary>
+			/// Returns a large allocation to the system
+			/// </summary>
+			void deallocateLarge(void* p)
+			{
+				LargeAllocation* allocation = reinterpret_cast<LargeAllocation*>(static_cast<char*>(p) - LARGE_HEADER_SIZE);
+				if (allocation->previous != nullptr) allocation->previous->next = allocation->next;
+				else _largeAllocations = allocation->next;
+				if (allocation->next != nullptr) allocation->next->previous = allocation->previous;
+
+				::operator delete(allocation);
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <filesystem>
+#include <type_traits>
+#include "XmlSerializable.h"
+#include "../../Callbacks/ProgressUpdateCallback.h"
+#include "../../Logging/CarouselLogger.h"
+
+namespace carousel
+{
+	namespace core
+	{
+		/// <summary>
+		/// Loads many serialized objects (e.g. all projects of a workspace) in parallel. Files are parsed
+		/// on worker threads, each worker uses its own pooled parser. Results are returned in sorted file
+		/// order, independent of the order in which workers finish.
+		/// Note: Xerces has to be initialized before loading.
+		/// </summary>
+		/// <param name="T">XmlSerializable object with a default constructor</param>
+		template<typename T>
+		class XmlBulkLoader
+		{
+			static_assert(std::is_base_of_v<XmlSerializable, T>, "XmlBulkLoader requires a XmlSerializable");
+
+		public:
+			/// <summary>
+			/// File that could not be loaded
+			/// </summary>
+			struct LoadError
+			{
+				std::string filepath;
+				std::string message;
+			};
+
+			/// <summary>
+			/// Loaded objects, objects[i] was loaded from filepaths[i]
+			/// </summary>
+			struct Result
+			{
+				std::vector<std::unique_ptr<T>> objects;
+				std::vector<std::string> filepaths;
+				std::vector<LoadError> errors;
+			};
+
+		private:
+			/// <summary>
+			/// Number of worker threads
+			/// </summary>
+			size_t _threadCount;
+
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			/// <param name="threadCount">Number of worker threads, 0 uses one thread per core</param>
+			XmlBulkLoader(size_t threadCount = 0) : _threadCount(threadCount)
+			{
+				if (_threadCount == 0) _threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+			}
+
+			/// <summary>
+			/// Loads all files with the given extension contained in the directory (not recursive)
+			/// </summary>
+			Result loadDirectory(const std::string& directory, const std::string& extension = ".xml") const
+			{
+				std::vector<std::string> filepaths;
+				for (const auto& entry : std::filesystem::directory_iterator(directory))
+				{
+					if (entry.is_regular_file() && entry.path().extension() == extension)
+					{
+						filepaths.push_back(entry.path().string());
+					}
+				}
+
+				return loadFiles(std::move(filepaths));
+			}
+
+			/// <summary>
+			/// Loads all files. Progress (0 to 100) is reported through ProgressUpdateCallback from
+			/// the calling thread. Files that can't be loaded are listed in the result errors.
+			/// </summary>
+			Result loadFiles(std::vector<std::string> filepaths) const
+			{
+				// Sorted order makes the result independent of directory listing and thread timing
+				std::sort(filepaths.begin(), filepaths.end());
+				filepaths.erase(std::unique(filepaths.begin(), filepaths.end()), filepaths.end());
+
+				size_t fileCount = filepaths.size();
+				std::vector<std::unique_ptr<T>> loaded(fileCount);
+				std::vector<std::string> errorMessages(fileCount);
+
+				std::atomic<size_t> nextFile{ 0 };
+				size_t completed{ 0 };
+				std::mutex completedMutex;
+				std::condition_variable completedChanged;
+
+				auto worker = [&]()
+				{
+					for (size_t index = nextFile++; index < fileCount; index = nextFile++)
+					{
+						try
+						{
+							std::unique_ptr<T> object = std::make_unique<T>();
+							object->loadFromXml(filepaths[index]);
+							loaded[index] = std::move(object);
+						}
+						catch (const std::exception& e)
+						{
+							errorMessages[index] = e.what();
+						}
+						catch (...)
+						{
+							errorMessages[index] = "Unknown error";
+						}
+
+						{
+							std::lock_guard<std::mutex> guard(completedMutex);
+							completed++;
+						}
+						completedChanged.notify_one();
+					}
+				};
+
+				std::vector<std::thread> workers;
+
+				// Joins started workers if starting another one or a progress callback throws,
+				// joinable threads must not be destroyed
+				struct WorkerJoiner
+				{
+					std::vector<std::thread>& threads;
+					~WorkerJoiner()
+					{
+						for (auto& thread : threads)
+						{
+							if (thread.joinable()) thread.join();
+						}
+					}
+				} joiner{ workers };
+
+				size_t workerCount = std::min(_threadCount, fileCount);
+				for (size_t i = 0; i < workerCount; i++)
+				{
+					workers.emplace_back(worker);
+				}
+
+				// Report progress from the calling thread, callbacks are never called concurrently
+				size_t reported{ 0 };
+				while (reported < fileCount)
+				{
+					{
+						std::unique_lock<std::mutex> lock(completedMutex);
+						completedChanged.wait(lock, [&]() { return completed > reported; });
+						reported = completed;
+					}
+
+					std::string message = "Loaded " + std::to_string(reported) + " of " + std::to_string(fileCount) + " files";
+					carousel::callbacks::ProgressUpdateCallback::TriggerCallback(message.data(), 100.0 * reported / fileCount);
+				}
+
+				for (auto& thread : workers)
+				{
+					thread.join();
+				}
+
+				// Merge in file order
+				Result result;
+				for (size_t i = 0; i < fileCount; i++)
+				{
+					if (loaded[i])
+					{
+						result.objects.push_back(std::move(loaded[i]));
+						result.filepaths.push_back(filepaths[i]);
+					}
+					else
+					{
+						carousel::logging::CarouselLogger::instance().warning("XmlBulkLoader: could not load " + filepaths[i] + ": " + errorMessages[i]);
+						result.errors.push_back(LoadError{ filepaths[i], errorMessages[i] });
+					}
+				}
+
+				return result;
+			}
+		};
+	}
+}
\ No newline at end of file
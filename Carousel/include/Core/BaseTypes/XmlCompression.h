@@ -0,0 +1,208 @@
+#pragma once
+
+#include <xercesc/sax/InputSource.hpp>
+#include <xercesc/util/BinInputStream.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
+#include <Poco/DeflatingStream.h>
+#include <Poco/InflatingStream.h>
+#include <string>
+#include <memory>
+#include <fstream>
+#include <stdexcept>
+#include "MappedFileInputSource.h"
+
+namespace carousel
+{
+	namespace core
+	{
+		/// <summary>
+		/// Stream that inflates a gzip file while Xerces reads it
+		/// </summary>
+		class CompressedFileInputStream : public xercesc::BinInputStream
+		{
+		private:
+			/// <summary>
+			/// Compressed file
+			/// </summary>
+			std::ifstream _file;
+
+			/// <summary>
+			/// Inflated content
+			/// </summary>
+			Poco::InflatingInputStream _inflating;
+
+			/// <summary>
+			/// Number of inflated bytes read
+			/// </summary>
+			XMLFilePos _position{ 0 };
+
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			CompressedFileInputStream(const std::string& filepath)
+				: _file(filepath, std::ios::binary), _inflating(_file, Poco::InflatingStreamBuf::STREAM_GZIP)
+			{
+				if (!_file.is_open()) throw std::runtime_error("CompressedFileInputStream: could not open " + filepath);
+			}
+
+			XMLFilePos curPos() const override
+			{
+				return _position;
+			}
+
+			XMLSize_t readBytes(XMLByte* const toFill, const XMLSize_t maxToRead) override
+			{
+				_inflating.read(reinterpret_cast<char*>(toFill), maxToRead);
+				XMLSize_t bytesRead = static_cast<XMLSize_t>(_inflating.gcount());
+				_position += bytesRead;
+				return bytesRead;
+			}
+
+			const XMLCh* getContentType() const override
+			{
+				return nullptr;
+			}
+		};
+
+		/// <summary>
+		/// Xerces input source for gzip compressed files, content is inflated while parsing
+		/// </summary>
+		class CompressedFileInputSource : public xercesc::InputSource
+		{
+		private:
+			/// <summary>
+			/// Compressed file
+			/// </summary>
+			std::string _filepath;
+
+		public:
+			/// <summary>
+			/// Constructor, the file path is used as system id
+			/// </summary>
+			CompressedFileInputSource(const std::string& filepath, xercesc::MemoryManager* manager = xercesc::XMLPlatformUtils::fgMemoryManager)
+				: xercesc::InputSource(filepath.c_str(), manager), _filepath(filepath)
+			{
+				// Empty
+			}
+
+			xercesc::BinInputStream* makeStream() const override
+			{
+				return new (getMemoryManager()) CompressedFileInputStream(_filepath);
+			}
+		};
+
+		/// <summary>
+		/// Output file that is gzip compressed if requested. Content is compressed while it is
+		/// written, no uncompressed copy is created.
+		/// </summary>
+		class CompressedOutputFile
+		{
+		private:
+			/// <summary>
+			/// Target file
+			/// </summary>
+			std::ofstream _file;
+
+			/// <summary>
+			/// Compressing stream, nullptr if not compressed
+			/// </summary>
+			std::unique_ptr<Poco::DeflatingOutputStream> _deflating;
+
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			/// <param name="filepath">full path</param>
+			/// <param name="compress">gzip compress content</param>
+			CompressedOutputFile(const std::string& filepath, bool compress = true) : _file(filepath, std::ios::binary)
+			{
+				if (!_file.is_open()) throw std::runtime_error("CompressedOutputFile: could not open " + filepath);
+				if (compress) _deflating = std::make_unique<Poco::DeflatingOutputStream>(_file, Poco::DeflatingStreamBuf::STREAM_GZIP);
+			}
+
+			/// <summary>
+			/// Destructor
+			/// </summary>
+			~CompressedOutputFile()
+			{
+				try
+				{
+					close();
+				}
+				catch (...)
+				{
+					// Call close() to get errors
+				}
+			}
+
+			/// <summary>
+			/// Returns the stream to write to
+			/// </summary>
+			std::ostream& stream()
+			{
+				if (_deflating) return *_deflating;
+				return _file;
+			}
+
+			/// <summary>
+			/// Finishes compression and closes the file
+			/// </summary>
+			void close()
+			{
+				if (_deflating)
+				{
+					_deflating->close();
+					_deflating.reset();
+				}
+
+				if (_file.is_open())
+				{
+					_file.close();
+					if (_file.fail()) throw std::runtime_error("CompressedOutputFile: could not write file");
+				}
+			}
+		};
+
+		/// <summary>
+		/// Helpers for compressed XML files
+		/// </summary>
+		class XmlCompression
+		{
+		public:
+			/// <summary>
+			/// Extension of compressed files
+			/// </summary>
+			static inline const std::string Extension{ ".gz" };
+
+			/// <summary>
+			/// Returns true if files saved to this path are compressed (extension .gz)
+			/// </summary>
+			static bool isCompressedPath(const std::string& filepath)
+			{
+				return filepath.size() >= Extension.size() && filepath.compare(filepath.size() - Extension.size(), Extension.size(), Extension) == 0;
+			}
+
+			/// <summary>
+			/// Returns true if the file content is gzip compressed
+			/// </summary>
+			static bool isCompressed(const std::string& filepath)
+			{
+				std::ifstream file(filepath, std::ios::binary);
+				unsigned char magic[2]{ 0, 0 };
+				file.read(reinterpret_cast<char*>(magic), sizeof(magic));
+				return file.gcount() == sizeof(magic) && magic[0] == 0x1F && magic[1] == 0x8B;
+			}
+
+			/// <summary>
+			/// Opens file for parsing, compressed files are inflated while parsing and uncompressed
+			/// files are memory mapped.
+			/// </summary>
+			static std::unique_ptr<xercesc::InputSource> openInputSource(const std::string& filepath)
+			{
+				if (isCompressed(filepath)) return std::make_unique<CompressedFileInputSource>(filepath);
+				return std::make_unique<MappedFileInputSource>(filepath);
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <xercesc/parsers/XercesDOMParser.hpp>
+#include <xercesc/framework/XMLGrammarPool.hpp>
+#include <xercesc/framework/XMLGrammarPoolImpl.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "XmlArenaMemoryManager.h"
+
+namespace carousel
+{
+	namespace core
+	{
+		/// <summary>
+		/// Holds the memory manager of a parser, base class so it is constructed before and
+		/// destroyed after the parser
+		/// </summary>
+		struct XmlArenaHolder
+		{
+			XmlArenaMemoryManager arena;
+		};
+
+		/// <summary>
+		/// DOM parser that owns an arena memory manager. The parser and all its documents are allocated
+		/// from the arena, threads that parse concurrently do not share an allocator.
+		/// </summary>
+		class XmlArenaDOMParser : private XmlArenaHolder, public xercesc::XercesDOMParser
+		{
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			/// <param name="grammarPool">Shared grammar pool, allocated with the global memory manager</param>
+			XmlArenaDOMParser(xercesc::XMLGrammarPool* grammarPool) : xercesc::XercesDOMParser(nullptr, &arena, grammarPool)
+			{
+				// Empty
+			}
+		};
+
+		/// <summary>
+		/// Thread safe pool of configured DOM parsers. Creating a XercesDOMParser is expensive, parsers
+		/// are therefore reused across loads and share a single grammar pool. Each parser allocates
+		/// from its own arena (see XmlArenaMemoryManager).
+		/// Note: Xerces has to be initialized before using the pool, call clear() before
+		///		  XMLPlatformUtils::Terminate.
+		/// </summary>
+		class XmlParserPool
+		{
+		public:
+			/// <summary>
+			/// Returns the parser to the pool when the owning handle is destroyed
+			/// </summary>
+			struct ParserReleaser
+			{
+				XmlParserPool* pool{ nullptr };
+
+				void operator()(xercesc::XercesDOMParser* parser) const
+				{
+					pool->release(parser);
+				}
+			};
+
+			/// <summary>
+			/// Parser handle, the parsed document is valid until the handle is destroyed
+			/// </summary>
+			typedef std::unique_ptr<xercesc::XercesDOMParser, ParserReleaser> PooledParser;
+
+		private:
+			/// <summary>
+			/// Grammar pool shared by all parsers
+			/// </summary>
+			std::unique_ptr<xercesc::XMLGrammarPool> _grammarPool;
+
+			/// <summary>
+			/// Idle parsers
+			/// </summary>
+			std::vector<std::unique_ptr<xercesc::XercesDOMParser>> _parsers;
+
+			/// <summary>
+			/// Maximum number of idle parsers kept by the pool
+			/// </summary>
+			size_t _maxIdleParsers{ 16 };
+
+			/// <summary>
+			/// True if parsers process namespaces
+			/// </summary>
+			bool _doNamespaces;
+
+			/// <summary>
+			/// Pool mutex
+			/// </summary>
+			std::mutex _poolMutex;
+
+			/// <summary>
+			/// Private constructor (Singleton)
+			/// </summary>
+			XmlParserPool(bool doNamespaces) : _doNamespaces(doNamespaces)
+			{
+				// Empty
+			}
+
+		public:
+			/// <summary>
+			/// Copy constructor (removed)
+			/// </summary>
+			XmlParserPool(const XmlParserPool&) = delete;
+
+			/// <summary>
+			/// Assignment operator (removed)
+			/// </summary>
+			void operator=(const XmlParserPool&) = delete;
+
+			/// <summary>
+			/// Gets the parser pool
+			/// </summary>
+			static XmlParserPool& instance()
+			{
+				static XmlParserPool _pool(false);
+				return _pool;
+			}
+
+			/// <summary>
+			/// Gets the pool of namespace aware parsers, used for the xsd data models
+			/// </summary>
+			static XmlParserPool& namespaceInstance()
+			{
+				static XmlParserPool _pool(true);
+				return _pool;
+			}
+
+		public:
+			/// <summary>
+			/// Returns an idle parser or creates a new one
+			/// </summary>
+			PooledParser acquire()
+			{
+				{
+					std::lock_guard<std::mutex> guard(_poolMutex);
+					if (!_parsers.empty())
+					{
+						xercesc::XercesDOMParser* parser = _parsers.back().release();
+						_parsers.pop_back();
+						return PooledParser(parser, ParserReleaser{ this });
+					}
+				}
+
+				return PooledParser(createParser(), ParserReleaser{ this });
+			}
+
+			/// <summary>
+			/// Sets the maximum number of idle parsers kept by the pool
+			/// </summary>
+			void setMaxIdleParsers(size_t maxIdleParsers)
+			{
+				std::lock_guard<std::mutex> guard(_poolMutex);
+				_maxIdleParsers = maxIdleParsers;
+				if (_parsers.size() > _maxIdleParsers) _parsers.resize(_maxIdleParsers);
+			}
+
+			/// <summary>
+			/// Removes all idle parsers and the grammar pool. Has to be called before
+			/// terminating xerces.
+			/// </summary>
+			void clear()
+			{
+				std::lock_guard<std::mutex> guard(_poolMutex);
+				_parsers.clear();
+				_grammarPool.reset();
+			}
+
+		private:
+			/// <summary>
+			/// Creates an arena backed parser without schema validation that uses the shared grammar pool
+			/// </summary>
+			xercesc::XercesDOMParser* createParser()
+			{
+				xercesc::XMLGrammarPool* grammarPool{ nullptr };
+				{
+					std::lock_guard<std::mutex> guard(_poolMutex);
+					if (!_grammarPool)
+					{
+						// Grammar pool is locked (read only), this makes it safe to share between threads
+						_grammarPool = std::make_unique<xercesc::XMLGrammarPoolImpl>(xercesc::XMLPlatformUtils::fgMemoryManager);
+						_grammarPool->lockPool();
+					}
+					grammarPool = _grammarPool.get();
+				}
+
+				xercesc::XercesDOMParser* parser = new XmlArenaDOMParser(grammarPool);
+				parser->setValidationScheme(xercesc::XercesDOMParser::Val_Never);
+				parser->setDoNamespaces(_doNamespaces);
+				parser->setDoSchema(false);
+				parser->setLoadExternalDTD(false);
+				parser->useCachedGrammarInParse(true);
+				return parser;
+			}
+
+			/// <summary>
+			/// Returns parser to the pool, documents created by the parser are released
+			/// </summary>
+			void release(xercesc::XercesDOMParser* parser)
+			{
+				std::unique_ptr<xercesc::XercesDOMParser> pooledParser(parser);
+				pooledParser->resetDocumentPool();
+
+				std::lock_guard<std::mutex> guard(_poolMutex);
+				if (_parsers.size() < _maxIdleParsers)
+				{
+					_parsers.push_back(std::move(pooledParser));
+				}
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <algorithm>
+#include <unordered_map>
+#include "XmlTranscoder.h"
+
+namespace carousel
+{
+	namespace core
+	{
+		/// <summary>
+		/// Registered properties of a serializable type, in registration order, with a name sorted
+		/// index for lookups. Tables are immutable and shared by all instances of a type that register
+		/// the same properties, so they are built once per type.
+		/// </summary>
+		class XmlPropertyTable
+		{
+		public:
+			/// <summary>
+			/// Returned by find if the property is not registered
+			/// </summary>
+			static constexpr size_t npos{ static_cast<size_t>(-1) };
+
+		private:
+			/// <summary>
+			/// Interned property names in registration order
+			/// </summary>
+			std::vector<const XmlTagNames::Entry*> _properties;
+
+			/// <summary>
+			/// Property names sorted by name (name, registration index)
+			/// </summary>
+			std::vector<std::pair<std::string_view, size_t>> _sorted;
+
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			/// <param name="properties">Interned property names in registration order</param>
+			XmlPropertyTable(std::vector<const XmlTagNames::Entry*> properties) : _properties(std::move(properties))
+			{
+				_sorted.reserve(_properties.size());
+				for (size_t i = 0; i < _properties.size(); i++)
+				{
+					_sorted.emplace_back(_properties[i]->first, i);
+				}
+
+				std::sort(_sorted.begin(), _sorted.end());
+			}
+
+			/// <summary>
+			/// Returns the shared table of the object type, the table is created by the first instance.
+			/// Instances that registered other properties get their own table.
+			/// </summary>
+			/// <param name="objectName">Name of the object (root tag name)</param>
+			/// <param name="properties">Interned property names of the instance in registration order</param>
+			static std::shared_ptr<const XmlPropertyTable> get(const std::string& objectName, std::vector<const XmlTagNames::Entry*> properties)
+			{
+				static std::unordered_map<std::string, std::shared_ptr<const XmlPropertyTable>> _tables;
+				static std::mutex _tablesMutex;
+
+				std::lock_guard<std::mutex> guard(_tablesMutex);
+				auto table = _tables.find(objectName);
+				if (table != _tables.end())
+				{
+					// Interned names are compared by address
+					if (table->second->_properties == properties) return table->second;
+					return std::make_shared<const XmlPropertyTable>(std::move(properties));
+				}
+
+				return _tables.emplace(objectName, std::make_shared<const XmlPropertyTable>(std::move(properties))).first->second;
+			}
+
+			/// <summary>
+			/// Returns the registration index of the property, or npos
+			/// </summary>
+			size_t find(std::string_view name) const
+			{
+				auto entry = std::lower_bound(_sorted.begin(), _sorted.end(), name,
+					[](const std::pair<std::string_view, size_t>& item, std::string_view value) { return item.first < value; });
+
+				if (entry == _sorted.end() || entry->first != name) return npos;
+				return entry->second;
+			}
+
+			/// <summary>
+			/// Returns the number of properties
+			/// </summary>
+			size_t size() const
+			{
+				return _properties.size();
+			}
+		};
+	}
+}
\ No newline at end of file
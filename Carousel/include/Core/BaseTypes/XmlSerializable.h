@@ -7,17 +7,34 @@
 #include <xercesc/util/PlatformUtils.hpp>
 #include <xercesc/util/XMLString.hpp>
 #include <xercesc/sax/HandlerBase.hpp>
+#include <xercesc/sax/SAXParseException.hpp>
 #include <xercesc/parsers/XercesDOMParser.hpp>
 #include <xercesc/framework/LocalFileFormatTarget.hpp>
 #include <xercesc/framework/MemBufFormatTarget.hpp>
 #include <xercesc/util/Xerces_autoconf_config.hpp>
 #include <iostream>
 #include <string>
-#include <map>
+#include <vector>
+#include <memory>
 #include <functional>
 #include <algorithm>
 #include <fstream>
+#include <filesystem>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <sstream>
 #include "../Interfaces/ISerializableObject.h"
+#include "OStreamFormatTarget.h"
+#include "XmlParserPool.h"
+#include "XmlStreamLoader.h"
+#include "XmlTranscoder.h"
+#include "XmlArenaMemoryManager.h"
+#include "MappedFileInputSource.h"
+#include "XmlCompression.h"
+#include "JsonWriter.h"
+#include "JsonInSituParser.h"
+#include "XmlPropertyTable.h"
 
 namespace carousel
 {
@@ -35,14 +52,14 @@ namespace carousel
 			struct Element
 			{
 				/// <summary>
-				/// Dom element
+				/// Interned property name
 				/// </summary>
-				xercesc::DOMElement* element;
+				const XmlTagNames::Entry* name;
 
 				/// <summary>
-				/// Dom element
+				/// Text node that contains the value
 				/// </summary>
-				xercesc::DOMNode* child;
+				xercesc::DOMText* text;
 
 				/// <summary>
 				/// Pointer to function that returns the value pointing to the DOM element
@@ -54,8 +71,18 @@ namespace carousel
 				/// Pointer to function for updating the model data
 				/// </summary>
 				std::function<void(const std::string&)> updateValue;
+
+				/// <summary>
+				/// Value currently contained in the DOM element, used for detecting changes
+				/// </summary>
+				std::string value;
 			};
 
+			/// <summary>
+			/// Memory manager of the DOM document, releases the whole document at once
+			/// </summary>
+			std::unique_ptr<XmlArenaMemoryManager> _memoryManager;
+
 			/// <summary>
 			/// DOM document
 			/// </summary>
@@ -72,83 +99,109 @@ namespace carousel
 			xercesc::DOMImplementation* _implementation;
 
 			/// <summary>
-			/// Node elements contained in root
+			/// Node elements contained in root, in registration order
 			/// </summary>
-			std::map<std::string, Element> _elements;
+			std::vector<Element> _elements;
+
+			/// <summary>
+			/// Property lookup table, shared with other instances of this type. Created on first lookup.
+			/// </summary>
+			std::shared_ptr<const XmlPropertyTable> _table;
+
+			/// <summary>
+			/// Name of the object (root tag name)
+			/// </summary>
+			std::string _objectName;
+
+			/// <summary>
+			/// True if the DOM changed since the last save or load
+			/// </summary>
+			bool _isModified{ true };
 
 		public:
 			/// <summary>
 			/// Constructor
 			/// </summary>
-			XmlSerializable(const std::string& objectName)
+			XmlSerializable(const std::string& objectName) : _memoryManager(std::make_unique<XmlArenaMemoryManager>()), _objectName(objectName)
 			{
 				// Initialize DOM
 				XMLCh tempStr[100];
 				xercesc::XMLString::transcode("LS", tempStr, 99);
 				_implementation = xercesc::DOMImplementationRegistry::getDOMImplementation(tempStr);
-				_document = _implementation->createDocument(0, xercesc::XMLString::transcode(objectName.c_str()), 0);
+				_document = _implementation->createDocument(0, XmlTagNames::get(objectName), 0, _memoryManager.get());
 				_root = _document->getDocumentElement();
 			}
 
+			/// <summary>
+			/// Copy constructor (removed), registered properties refer to the owning object
+			/// </summary>
+			XmlSerializable(const XmlSerializable&) = delete;
+
+			/// <summary>
+			/// Assignment operator (removed)
+			/// </summary>
+			void operator=(const XmlSerializable&) = delete;
+
+			/// <summary>
+			/// Destructor
+			/// </summary>
+			virtual ~XmlSerializable()
+			{
+				_document->release();
+			}
+
 #pragma region ISerializableObject 
 			void saveToXml(const std::string& filepath) override
 			{
-				// Empty elements means that ISerializableObject is not implemented
-				// correctly (Missing elements)
-				if (_elements.empty() == 0)
-				{
-					std::string xmlContent = serialize();
-					saveToFile(filepath, xmlContent);
-				}
+				saveToXml(filepath, false);
 			}
 
 			void loadFromXml(const std::string& filepath) override
 			{
-				// initialize parse with nullptr
-				xercesc::XercesDOMParser* parser = nullptr;
+				// Compressed files are detected by content
+				std::unique_ptr<xercesc::InputSource> source = XmlCompression::openInputSource(filepath);
+				loadFromXml(*source);
+			}
+#pragma endregion
 
+			/// <summary>
+			/// Loads from input source (e.g. xercesc::MemBufInputSource for xml held in memory)
+			/// </summary>
+			void loadFromXml(const xercesc::InputSource& source)
+			{
 				try
 				{
-					parser = parseFile(filepath);
+					// Parser is returned to the pool when leaving this scope
+					XmlParserPool::PooledParser parser = parseSource(source);
 
 					// Create document and fill nodes
 					xercesc::DOMDocument* document = parser->getDocument();
 					xercesc::DOMElement* root = document->getDocumentElement();
 
 					// Check if root tags refer to the same object
-					std::string loadedRootName(xercesc::XMLString::transcode(root->getTagName()));
-					std::string currentRootName(xercesc::XMLString::transcode(_root->getTagName()));
-					if (loadedRootName == currentRootName)
+					if (xercesc::XMLString::equals(root->getTagName(), _root->getTagName()))
 					{
-						// Read each node and update child node
-						xercesc::DOMNodeList* children = root->getChildNodes();
-						size_t childrenCount = children->getLength();
+						// Saved files contain the properties in registration order, each element is
+						// first compared to the next expected property
+						static const XMLCh emptyText[]{ 0 };
+						size_t expected{ 0 };
 
-						for (size_t i = 0; i < childrenCount; i++)
+						for (xercesc::DOMElement* childElement = root->getFirstElementChild(); childElement != nullptr; childElement = childElement->getNextElementSibling())
 						{
-							// Each element represents a property
-							xercesc::DOMElement* childElement = dynamic_cast<xercesc::DOMElement*>(children->item(i));
-							if (childElement != nullptr)
+							// Each element represents a property, unregistered properties are ignored
+							size_t index = findElement(childElement->getTagName(), expected);
+							if (index == XmlPropertyTable::npos) continue;
+
+							// Properties are simple values, the first child holds the text
+							xercesc::DOMNode* childText = childElement->getFirstChild();
+							if (childText != nullptr && childText->getNodeType() != xercesc::DOMNode::TEXT_NODE && childText->getNodeType() != xercesc::DOMNode::CDATA_SECTION_NODE)
 							{
-								// Get property name and check if it is registered. If this property is registered
-								// update child node.
-								std::string childTagName(xercesc::XMLString::transcode(childElement->getTagName()));
-								auto isContained = _elements.find(childTagName) != _elements.end();
-								if (isContained)
-								{
-									// If type is of DOMText, update using replaceWholeText
-									xercesc::DOMText* childText = dynamic_cast<xercesc::DOMText*>(_elements[childTagName].child);
-									if (childText != nullptr)
-									{
-										childText->replaceWholeText(((xercesc::DOMText*)childElement->getFirstChild())->getWholeText());
-									}
-									else
-									{
-										// For now we keep this simple and just implement the DOMText
-										throw std::runtime_error("Loading xml with children type other than DOMText is not yet implemented.");
-									}
-								}
+								// For now we keep this simple and just implement the DOMText
+								throw std::runtime_error("Loading xml with children type other than DOMText is not yet implemented.");
 							}
+
+							_elements[index].text->setData(childText != nullptr ? static_cast<xercesc::DOMText*>(childText)->getWholeText() : emptyText);
+							expected = index + 1;
 						}
 					}
 					else
@@ -157,70 +210,324 @@ namespace carousel
 						throw std::runtime_error("XmlSerializable can't load this file into this structure.");
 					}
 
-					// cleanup and update values to data model
-					delete parser;
+					// update values to data model
 					updateValuesToSource();
+					_isModified = false;
 				}
 				catch (const xercesc::DOMException& e) {
 					char* message = xercesc::XMLString::transcode(e.getMessage());
 					std::string errorMessage = "DOMException: " + std::string(message);
 					xercesc::XMLString::release(&message);
-					delete parser;
 					throw std::runtime_error(errorMessage);
 				}
 				catch (const xercesc::XMLException& e) {
 					char* message = xercesc::XMLString::transcode(e.getMessage());
 					std::string errorMessage = "XMLException: " + std::string(message);
 					xercesc::XMLString::release(&message);
-					delete parser;
 					throw std::runtime_error(errorMessage);
 				}
-				catch (const std::exception& e) {
-					delete parser;
-					throw; // Rethrow the caught exception
+			}
+
+			/// <summary>
+			/// Saves object into a file, data is written directly into the file without intermediate copies.
+			/// If atomic is set, data is written into a uniquely named temporary file next to the target that replaces it
+			/// once complete, this way the target file never contains partial content. Files with
+			/// extension .gz are gzip compressed while writing.
+			/// </summary>
+			/// <param name="filepath">full path</param>
+			/// <param name="atomic">write then rename</param>
+			void saveToXml(const std::string& filepath, bool atomic)
+			{
+				// Empty elements means that ISerializableObject is not implemented
+				// correctly (Missing elements)
+				if (_elements.empty()) return;
+
+				std::string targetPath = atomic ? temporaryPath(filepath) : filepath;
+
+				// A failed atomic save leaves neither partial content nor the temporary file behind
+				auto discardTemporary = [&]()
+				{
+					if (!atomic) return;
+					std::error_code ignored;
+					std::filesystem::remove(targetPath, ignored);
+				};
+
+				try
+				{
+					if (XmlCompression::isCompressedPath(filepath))
+					{
+						CompressedOutputFile output(targetPath);
+						serialize(output.stream());
+						output.close();
+					}
+					else
+					{
+						// File is closed when the target is destroyed
+						xercesc::LocalFileFormatTarget target(targetPath.c_str());
+						serialize(&target);
+					}
+
+					if (atomic)
+					{
+						std::filesystem::rename(targetPath, filepath);
+					}
+				}
+				catch (const xercesc::XMLException& e) {
+					discardTemporary();
+					char* message = xercesc::XMLString::transcode(e.getMessage());
+					std::string errorMessage = "XMLException: " + std::string(message);
+					xercesc::XMLString::release(&message);
+					throw std::runtime_error(errorMessage);
+				}
+				catch (...) {
+					discardTemporary();
+					throw;
 				}
+
+				_isModified = false;
+			}
+
+			/// <summary>
+			/// Saves object into a file only if the object changed since the last save or load
+			/// (e.g. autosave). Returns true if the file was written.
+			/// </summary>
+			/// <param name="filepath">full path</param>
+			/// <param name="atomic">write then rename</param>
+			bool saveToXmlIfModified(const std::string& filepath, bool atomic = false)
+			{
+				if (!isModified()) return false;
+
+				saveToXml(filepath, atomic);
+				return true;
+			}
+
+			/// <summary>
+			/// Returns true if the object changed since the last save or load
+			/// </summary>
+			bool isModified()
+			{
+				updateValuesFromSource();
+				return _isModified;
+			}
+
+			/// <summary>
+			/// Loads from xml file without building a DOM, values are passed directly to the
+			/// registered update functions.
+			/// </summary>
+			void loadFromXmlStream(const std::string& filepath)
+			{
+				XmlStreamLoader loader(_objectName, 1, [this](const std::string& name, const std::string& value) { updateProperty(name, value); });
+				if (loader.load(filepath) == 0)
+				{
+					// Wrong root name tag
+					throw std::runtime_error("XmlSerializable can't load this file into this structure.");
+				}
+			}
+
+			/// <summary>
+			/// Loads all objects of type T contained in the root element of a file (e.g. exported result
+			/// sets) without building a DOM. Each element is read into a new object that is handed to
+			/// onObject, properties missing in an element keep their default values. Only one object
+			/// is kept at a time, memory use does not depend on the file size.
+			/// </summary>
+			/// <param name="T">XmlSerializable object with a default constructor</param>
+			/// <param name="filepath">full path</param>
+			/// <param name="onObject">Called for each loaded object</param>
+			/// <returns>Number of loaded objects</returns>
+			template<typename T>
+			static size_t loadAllFromXmlStream(const std::string& filepath, const std::function<void(T&)>& onObject)
+			{
+				std::unique_ptr<T> object = std::make_unique<T>();
+				std::string objectName = static_cast<XmlSerializable&>(*object)._objectName;
+
+				XmlStreamLoader loader(objectName, 2,
+					[&object](const std::string& name, const std::string& value) { static_cast<XmlSerializable&>(*object).updateProperty(name, value); },
+					[&object, &onObject]()
+					{
+						onObject(*object);
+						object = std::make_unique<T>();
+					});
+
+				return loader.load(filepath);
+			}
+
+			/// <summary>
+			/// Returns the name of the object (root tag name)
+			/// </summary>
+			const std::string& getObjectName() const
+			{
+				return _objectName;
+			}
+
+			/// <summary>
+			/// Serializes the registered properties into a flat JSON object in a single pass, the DOM
+			/// is not involved. Values are written as JSON strings.
+			/// </summary>
+			std::string toJson() const
+			{
+				std::string json;
+				JsonWriter writer(json);
+				writeJson(writer);
+				return json;
+			}
+
+			/// <summary>
+			/// Serializes objects into a JSON array
+			/// </summary>
+			/// <param name="objects">Container of pointers to XmlSerializable objects</param>
+			template<typename Container>
+			static std::string toJsonArray(const Container& objects)
+			{
+				std::string json;
+				JsonWriter writer(json);
+				writer.beginArray();
+				for (const auto& object : objects)
+				{
+					static_cast<const XmlSerializable&>(*object).writeJson(writer);
+				}
+				writer.endArray();
+				return json;
+			}
+
+			/// <summary>
+			/// Loads values from a JSON object created by toJson, unknown members are ignored. The string
+			/// is parsed in place, move it in to avoid a copy.
+			/// </summary>
+			void loadFromJson(std::string json)
+			{
+				JsonInSituParser parser(json.data(), json.data() + json.size(),
+					[this](std::string_view name, std::string_view value) { updateProperty(std::string(name), std::string(value)); });
+
+				if (parser.parse() != 1)
+				{
+					throw std::runtime_error("XmlSerializable: JSON has to contain a single object.");
+				}
+			}
+
+			/// <summary>
+			/// Loads all objects of type T contained in a JSON array created by toJsonArray. Each element
+			/// is read into a new object that is handed to onObject, members missing in an element keep
+			/// their default values.
+			/// </summary>
+			/// <param name="T">XmlSerializable object with a default constructor</param>
+			/// <param name="json">JSON array, parsed in place</param>
+			/// <param name="onObject">Called for each loaded object</param>
+			/// <returns>Number of loaded objects</returns>
+			template<typename T>
+			static size_t loadAllFromJson(std::string json, const std::function<void(T&)>& onObject)
+			{
+				std::unique_ptr<T> object = std::make_unique<T>();
+
+				JsonInSituParser parser(json.data(), json.data() + json.size(),
+					[&object](std::string_view name, std::string_view value) { static_cast<XmlSerializable&>(*object).updateProperty(std::string(name), std::string(value)); },
+					[&object, &onObject]()
+					{
+						onObject(*object);
+						object = std::make_unique<T>();
+					});
+
+				return parser.parse();
 			}
-#pragma endregion
 
 		private:
 			/// <summary>
-			/// Saves string content into a file
+			/// Writes registered properties as JSON object
+			/// </summary>
+			void writeJson(JsonWriter& writer) const
+			{
+				writer.beginObject();
+				for (const auto& element : _elements)
+				{
+					writer.member(element.name->first, element.stringValue());
+				}
+				writer.endObject();
+			}
+
+			/// <summary>
+			/// Updates the model value of a registered property, unknown properties are ignored
+			/// </summary>
+			void updateProperty(const std::string& propertyName, const std::string& value)
+			{
+				size_t index = table().find(propertyName);
+				if (index != XmlPropertyTable::npos)
+				{
+					_elements[index].updateValue(value);
+				}
+			}
+
+			/// <summary>
+			/// Returns the property lookup table
 			/// </summary>
-			/// <param name="filename">full path</param>
-			/// <param name="content">content to be saved into the file</param>
-			void saveToFile(const std::string& filename, const std::string& content) {
-				std::ofstream outFile(filename);
+			const XmlPropertyTable& table()
+			{
+				if (!_table)
+				{
+					std::vector<const XmlTagNames::Entry*> names;
+					names.reserve(_elements.size());
+					for (const auto& element : _elements)
+					{
+						names.push_back(element.name);
+					}
 
-				if (outFile.is_open()) {
-					outFile << content;
-					outFile.close();
-					std::cout << "File saved successfully." << std::endl;
+					_table = XmlPropertyTable::get(_objectName, std::move(names));
 				}
-				else {
-					std::cerr << "Error opening file for writing." << std::endl;
+
+				return *_table;
+			}
+
+			/// <summary>
+			/// Returns the index of the element with the tag name, or XmlPropertyTable::npos. The
+			/// expected element is checked first without transcoding the tag name.
+			/// </summary>
+			size_t findElement(const XMLCh* tagName, size_t expected)
+			{
+				if (expected < _elements.size() && xercesc::XMLString::equals(tagName, _elements[expected].name->second.c_str()))
+				{
+					return expected;
 				}
+
+				return table().find(XmlTranscoder::local().toString(tagName));
 			}
 
-			xercesc::XercesDOMParser* parseFile(const std::string& filename)
+			/// <summary>
+			/// Returns a temporary file name next to the target that is unique across threads and processes
+			/// </summary>
+			static std::string temporaryPath(const std::string& filepath)
 			{
-				// Create parser without schema validation
-				xercesc::XercesDOMParser* parser = new xercesc::XercesDOMParser();
-				parser->setValidationScheme(xercesc::XercesDOMParser::Val_Never);
-				parser->setDoNamespaces(false);
-				parser->setDoSchema(false);
-				parser->setLoadExternalDTD(false);
+				static const unsigned int processKey = std::random_device{}();
+				static std::atomic<unsigned long long> counter{ 0 };
+
+				std::ostringstream path;
+				path << filepath << "." << std::hex << processKey << "." << std::hash<std::thread::id>{}(std::this_thread::get_id()) << "." << counter++ << ".tmp";
+				return path.str();
+			}
 
-				xercesc::DOMDocument* document = nullptr;
+			/// <summary>
+			/// Parses input source using a pooled parser
+			/// </summary>
+			XmlParserPool::PooledParser parseSource(const xercesc::InputSource& source)
+			{
+				// Parser without schema validation
+				XmlParserPool::PooledParser parser = XmlParserPool::instance().acquire();
 
 				try
 				{
-					// Parse file
-					parser->parse(xercesc::XMLString::transcode(filename.c_str()));
+					parser->parse(source);
 				}
 				catch (const std::exception& ex)
 				{
 					throw std::runtime_error(ex.what());
 				}
+				catch (const xercesc::SAXParseException& e)
+				{
+					// Malformed documents are reported with their position
+					throw std::runtime_error("SAXParseException: " + XmlTranscoder::local().toString(e.getMessage()) +
+						" (line " + std::to_string(e.getLineNumber()) + ", column " + std::to_string(e.getColumnNumber()) + ")");
+				}
+				catch (const xercesc::XMLException& e)
+				{
+					throw std::runtime_error("XMLException: " + XmlTranscoder::local().toString(e.getMessage()));
+				}
 
 				return parser;
 			}
@@ -233,30 +540,26 @@ namespace carousel
 			/// <param name="valueFunction">Function that returns the value as a string</param>
 			void registerProperty(const std::string& propertyName, std::function<std::string()> valueFunction, std::function<void(const std::string&)> updateFunction)
 			{
-				// Check if property is not already assigned
-				if (_elements.count(propertyName) == 0)
-				{
-					// Create new node and add to root document
-					xercesc::DOMElement* domElement = _document->createElement(xercesc::XMLString::transcode(propertyName.c_str()));
-					_root->appendChild(domElement);
-
-					xercesc::DOMText* nameText = _document->createTextNode(xercesc::XMLString::transcode(valueFunction().c_str()));
-					domElement->appendChild(nameText);
-
-					// Create reference to node for updating the value before save
-					Element newElement;
-					newElement.stringValue = valueFunction;
-					newElement.updateValue = updateFunction;
-					newElement.element = domElement;
-					newElement.child = nameText;
-
-					// Add into reference list
-					_elements.insert(std::pair<std::string, Element>(propertyName, newElement));
-				}
-				else
+				// Check if property is not already assigned, interned names are compared by address
+				const XmlTagNames::Entry* name = &XmlTagNames::entry(propertyName);
+				for (const auto& element : _elements)
 				{
-					throw std::exception("");
+					if (element.name == name) throw std::runtime_error("XmlSerializable: property " + propertyName + " is already registered.");
 				}
+
+				// Create new node and add to root document
+				xercesc::DOMElement* domElement = _document->createElement(name->second.c_str());
+				_root->appendChild(domElement);
+
+				std::string value = valueFunction();
+				xercesc::DOMText* valueText = _document->createTextNode(XmlTranscoder::local().toXml(value));
+				domElement->appendChild(valueText);
+
+				// Create reference to node for updating the value before save
+				_elements.push_back(Element{ name, valueText, std::move(valueFunction), std::move(updateFunction), std::move(value) });
+
+				// Lookup table is created again on next use
+				_table.reset();
 			}
 
 			/// <summary>
@@ -266,34 +569,43 @@ namespace carousel
 			{
 				for (auto& element : _elements)
 				{
-					auto fr = dynamic_cast<xercesc::DOMText*>(element.second.child);
-					std::string testy(xercesc::XMLString::transcode(fr->getWholeText()));
-					element.second.updateValue(testy);
+					std::string value = XmlTranscoder::local().toString(element.text->getWholeText());
+					element.updateValue(value);
+					element.value = std::move(value);
 				}
 			}
 
 			/// <summary>
-			/// Updates model values to what this DOM contains
+			/// Updates model values to what this DOM contains. Only elements whose value changed
+			/// are updated, returns true if any element changed.
 			/// </summary>
-			void updateValuesFromSource()
+			bool updateValuesFromSource()
 			{
+				bool isChanged{ false };
 				for (auto& element : _elements)
 				{
-					updateValueFromSource(element.second);
+					isChanged = updateValueFromSource(element) || isChanged;
 				}
+
+				_isModified = _isModified || isChanged;
+				return isChanged;
 			}
 
 			/// <summary>
-			/// Updates DOM element using data from model
+			/// Updates DOM element using data from model if the value changed. Returns true
+			/// if the element was updated.
 			/// </summary>
 			/// <param name="element">Element, reference to property</param>
-			void updateValueFromSource(const Element& element)
+			bool updateValueFromSource(Element& element)
 			{
-				// If object is of type DOMText
-				if (dynamic_cast<xercesc::DOMText*>(element.child) != nullptr)
-				{
-					((xercesc::DOMText*)element.child)->replaceWholeText(xercesc::XMLString::transcode(element.stringValue().c_str()));
-				}
+				std::string value = element.stringValue();
+				if (value == element.value) return false;
+
+				// Text node is the only child of the element
+				element.text->setData(XmlTranscoder::local().toXml(value));
+
+				element.value = std::move(value);
+				return true;
 			}
 
 
@@ -302,28 +614,53 @@ namespace carousel
 			/// Serializes object to XML and returns the structure in a string
 			/// </summary>
 			std::string serialize()
+			{
+				xercesc::MemBufFormatTarget target;
+				serialize(&target);
+
+				// Convert memory buffer to std::string
+				return std::string((const char*)target.getRawBuffer(), target.getLen());
+			}
+
+			/// <summary>
+			/// Serializes object to XML directly into the stream
+			/// </summary>
+			void serialize(std::ostream& stream)
+			{
+				OStreamFormatTarget target(stream);
+				serialize(&target);
+			}
+
+		protected:
+			/// <summary>
+			/// Serializes object to XML into the format target
+			/// </summary>
+			void serialize(xercesc::XMLFormatTarget* target)
 			{
 				// update values before serialize
 				updateValuesFromSource();
 
-				// setup dom serializer and targets
+				// setup dom serializer and target
 				xercesc::DOMLSSerializer* serializer = ((xercesc::DOMImplementationLS*)_implementation)->createLSSerializer();
 				xercesc::DOMLSOutput* output = ((xercesc::DOMImplementationLS*)_implementation)->createLSOutput();
-				xercesc::MemBufFormatTarget* target = new xercesc::MemBufFormatTarget();
 				output->setByteStream(target);
 
-				// Serialize the DOM document to memory buffer
-				serializer->write(_document, output);
-
-				// Convert memory buffer to std::string
-				std::string xmlString = std::string((const char*)target->getRawBuffer(), target->getLen());
+				try
+				{
+					// Serialize the DOM document to target
+					serializer->write(_document, output);
+					target->flush();
+				}
+				catch (...)
+				{
+					output->release();
+					serializer->release();
+					throw;
+				}
 
 				// Clean up
 				output->release();
 				serializer->release();
-				delete target;
-
-				return xmlString;
 			}
 		};
 
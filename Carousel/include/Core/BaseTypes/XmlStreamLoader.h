@@ -0,0 +1,201 @@
+#pragma once
+
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/sax/SAXParseException.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUni.hpp>
+#include <string>
+#include <memory>
+#include <functional>
+#include <stdexcept>
+#include "XmlTranscoder.h"
+#include "XmlCompression.h"
+
+namespace carousel
+{
+	namespace core
+	{
+		/// <summary>
+		/// Streaming (SAX2) loader for XmlSerializable files. Property values are handed to a callback
+		/// as soon as the element is read, no DOM is built. Files that contain many repeated objects
+		/// (e.g. exported result sets) are read in constant memory.
+		/// </summary>
+		class XmlStreamLoader : public xercesc::DefaultHandler
+		{
+		public:
+			/// <summary>
+			/// Called for each property (property name, value)
+			/// </summary>
+			typedef std::function<void(const std::string&, const std::string&)> PropertyCallback;
+
+			/// <summary>
+			/// Called after all properties of an object were read
+			/// </summary>
+			typedef std::function<void()> ObjectCallback;
+
+		private:
+			/// <summary>
+			/// Tag name of the object
+			/// </summary>
+			std::string _objectName;
+
+			/// <summary>
+			/// Interned tag name of the object
+			/// </summary>
+			const XMLCh* _objectTag;
+
+			/// <summary>
+			/// Depth at which objects are found, 1 for the root element
+			/// </summary>
+			size_t _objectDepth;
+
+			/// <summary>
+			/// Property callback
+			/// </summary>
+			PropertyCallback _onProperty;
+
+			/// <summary>
+			/// Object callback
+			/// </summary>
+			ObjectCallback _onObject;
+
+			/// <summary>
+			/// Current element depth
+			/// </summary>
+			size_t _depth{ 0 };
+
+			/// <summary>
+			/// Number of objects read
+			/// </summary>
+			size_t _objectCount{ 0 };
+
+			/// <summary>
+			/// True while reading an object with the expected tag name
+			/// </summary>
+			bool _isObject{ false };
+
+			/// <summary>
+			/// True while reading a property of an object
+			/// </summary>
+			bool _isProperty{ false };
+
+			/// <summary>
+			/// Name of the property that is being read
+			/// </summary>
+			std::string _propertyName;
+
+			/// <summary>
+			/// Value of the property that is being read, reused for all properties
+			/// </summary>
+			std::basic_string<XMLCh> _propertyValue;
+
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			/// <param name="objectName">Tag name of the object</param>
+			/// <param name="objectDepth">Depth of the objects, 1 if the object is the root element</param>
+			/// <param name="onProperty">Property callback</param>
+			/// <param name="onObject">Object callback</param>
+			XmlStreamLoader(std::string objectName, size_t objectDepth, PropertyCallback onProperty, ObjectCallback onObject = nullptr)
+				: _objectName(std::move(objectName)), _objectTag(XmlTagNames::get(_objectName)), _objectDepth(objectDepth), _onProperty(std::move(onProperty)), _onObject(std::move(onObject))
+			{
+				// Empty
+			}
+
+			/// <summary>
+			/// Reads file and returns the number of objects found
+			/// </summary>
+			size_t load(const std::string& filepath)
+			{
+				// Reset state
+				_depth = 0;
+				_objectCount = 0;
+				_isObject = false;
+				_isProperty = false;
+
+				// Reader without validation
+				std::unique_ptr<xercesc::SAX2XMLReader> reader(xercesc::XMLReaderFactory::createXMLReader());
+				reader->setFeature(xercesc::XMLUni::fgSAX2CoreValidation, false);
+				reader->setFeature(xercesc::XMLUni::fgSAX2CoreNameSpaces, false);
+				reader->setFeature(xercesc::XMLUni::fgXercesLoadExternalDTD, false);
+				reader->setContentHandler(this);
+				reader->setErrorHandler(this);
+
+				try
+				{
+					// Compressed files are inflated while reading
+					std::unique_ptr<xercesc::InputSource> source = XmlCompression::openInputSource(filepath);
+					reader->parse(*source);
+				}
+				catch (const xercesc::SAXParseException& e)
+				{
+					throw std::runtime_error("SAXParseException: " + toString(e.getMessage()));
+				}
+				catch (const xercesc::XMLException& e)
+				{
+					throw std::runtime_error("XMLException: " + toString(e.getMessage()));
+				}
+
+				return _objectCount;
+			}
+
+		public: // DefaultHandler
+
+			void startElement(const XMLCh* const uri, const XMLCh* const localname, const XMLCh* const qname, const xercesc::Attributes& attrs) override
+			{
+				_depth++;
+
+				if (_depth == _objectDepth)
+				{
+					// Objects with another tag name are skipped
+					_isObject = xercesc::XMLString::equals(qname, _objectTag);
+				}
+				else if (_depth == _objectDepth + 1 && _isObject)
+				{
+					// Each element of an object represents a property
+					_isProperty = true;
+					_propertyName = toString(qname);
+					_propertyValue.clear();
+				}
+			}
+
+			void endElement(const XMLCh* const uri, const XMLCh* const localname, const XMLCh* const qname) override
+			{
+				if (_depth == _objectDepth + 1 && _isProperty)
+				{
+					_isProperty = false;
+					_onProperty(_propertyName, toString(_propertyValue.c_str()));
+				}
+				else if (_depth == _objectDepth && _isObject)
+				{
+					_isObject = false;
+					_objectCount++;
+					if (_onObject) _onObject();
+				}
+
+				_depth--;
+			}
+
+			void characters(const XMLCh* const chars, const XMLSize_t length) override
+			{
+				if (_isProperty && _depth == _objectDepth + 1)
+				{
+					_propertyValue.append(chars, length);
+				}
+			}
+
+		private:
+			/// <summary>
+			/// Transcodes xerces string
+			/// </summary>
+			static std::string toString(const XMLCh* value)
+			{
+				return XmlTranscoder::local().toString(value);
+			}
+		};
+	}
+}
\ No newline at end of file
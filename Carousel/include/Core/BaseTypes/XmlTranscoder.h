@@ -0,0 +1,141 @@
+#pragma once
+
+#include <xercesc/util/XMLString.hpp>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+
+namespace carousel
+{
+	namespace core
+	{
+		/// <summary>
+		/// Transcodes between std::string and XMLCh using reusable buffers. Nothing has to be released
+		/// by the caller, returned XMLCh pointers are valid until the next call on the same thread.
+		/// </summary>
+		class XmlTranscoder
+		{
+		private:
+			/// <summary>
+			/// Buffer for XMLCh output
+			/// </summary>
+			std::vector<XMLCh> _xmlBuffer;
+
+			/// <summary>
+			/// Buffer for char output
+			/// </summary>
+			std::vector<char> _charBuffer;
+
+		public:
+			/// <summary>
+			/// Returns the transcoder of the calling thread
+			/// </summary>
+			static XmlTranscoder& local()
+			{
+				thread_local XmlTranscoder _transcoder;
+				return _transcoder;
+			}
+
+		public:
+			/// <summary>
+			/// Transcodes value to XMLCh, valid until the next call to toXml on this thread
+			/// </summary>
+			const XMLCh* toXml(const std::string& value)
+			{
+				// Each char results in at most one XMLCh
+				if (_xmlBuffer.size() < value.size() + 1) _xmlBuffer.resize(value.size() + 1);
+				xercesc::XMLString::transcode(value.c_str(), _xmlBuffer.data(), value.size());
+				return _xmlBuffer.data();
+			}
+
+			/// <summary>
+			/// Transcodes XMLCh value to string
+			/// </summary>
+			std::string toString(const XMLCh* value)
+			{
+				if (value == nullptr) return "";
+
+				// Each XMLCh results in at most four chars (multibyte code pages)
+				XMLSize_t maxChars = xercesc::XMLString::stringLen(value) * 4;
+				if (_charBuffer.size() < maxChars + 1) _charBuffer.resize(maxChars + 1);
+				xercesc::XMLString::transcode(value, _charBuffer.data(), maxChars);
+				return std::string(_charBuffer.data());
+			}
+		};
+
+		/// <summary>
+		/// Interned XMLCh tag names. Tag names are fixed per class, these are transcoded once and
+		/// shared by all instances.
+		/// </summary>
+		class XmlTagNames
+		{
+		public:
+			/// <summary>
+			/// Interned name (name, transcoded name), entries are never moved or removed
+			/// </summary>
+			typedef std::pair<const std::string, std::basic_string<XMLCh>> Entry;
+
+		private:
+			/// <summary>
+			/// Interned names (name, transcoded name)
+			/// </summary>
+			std::unordered_map<std::string, std::basic_string<XMLCh>> _names;
+
+			/// <summary>
+			/// Cache mutex
+			/// </summary>
+			std::mutex _namesMutex;
+
+			/// <summary>
+			/// Private constructor (Singleton)
+			/// </summary>
+			XmlTagNames() = default;
+
+		public:
+			/// <summary>
+			/// Copy constructor (removed)
+			/// </summary>
+			XmlTagNames(const XmlTagNames&) = delete;
+
+			/// <summary>
+			/// Assignment operator (removed)
+			/// </summary>
+			void operator=(const XmlTagNames&) = delete;
+
+			/// <summary>
+			/// Returns the transcoded tag name, valid for the lifetime of the program
+			/// </summary>
+			static const XMLCh* get(const std::string& name)
+			{
+				return entry(name).second.c_str();
+			}
+
+			/// <summary>
+			/// Returns the interned entry, equal names always return the same entry
+			/// </summary>
+			static const Entry& entry(const std::string& name)
+			{
+				static XmlTagNames _tagNames;
+				return _tagNames.intern(name);
+			}
+
+		private:
+			/// <summary>
+			/// Transcodes name if it is not yet contained in the cache
+			/// </summary>
+			const Entry& intern(const std::string& name)
+			{
+				std::lock_guard<std::mutex> guard(_namesMutex);
+
+				auto entry = _names.find(name);
+				if (entry == _names.end())
+				{
+					entry = _names.emplace(name, std::basic_string<XMLCh>(XmlTranscoder::local().toXml(name))).first;
+				}
+
+				return *entry;
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -1,9 +1,25 @@
 #pragma once
 
+#include <string>
+
 /// <summary>
 /// Interface for IPC communication
 /// </summary>
 class Ipc
 {
+public:
+	/// <summary>
+	/// Destructor
+	/// </summary>
+	virtual ~Ipc() = default;
+
+	/// <summary>
+	/// Returns true if communication channel is ready
+	/// </summary>
+	virtual bool isReady() const = 0;
 
+	/// <summary>
+	/// Reads the next message
+	/// </summary>
+	virtual std::string read() = 0;
 };
\ No newline at end of file
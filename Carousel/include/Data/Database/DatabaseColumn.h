@@ -32,6 +32,16 @@ namespace carousel
 			/// </summary>
 			DatabaseConstraintType _constraint{ DatabaseConstraintType::COLUMN };
 
+			/// <summary>
+			/// Name of the table referenced by this column (foreign keys only)
+			/// </summary>
+			std::string _referencedTable{ "" };
+
+			/// <summary>
+			/// Name of the column referenced by this column (foreign keys only)
+			/// </summary>
+			std::string _referencedColumn{ "" };
+
 			/// <summary>
 			/// Getter method for this column from object
 			/// </summary>
@@ -69,6 +79,27 @@ namespace carousel
 			/// </summary>
 			const DatabaseConstraintType& getConstraint() const { return _constraint; }
 
+			/// <summary>
+			/// Returns the name of the referenced table, empty if column is not a foreign key
+			/// </summary>
+			const std::string& getReferencedTable() const { return _referencedTable; }
+
+			/// <summary>
+			/// Returns the name of the referenced column, empty if column is not a foreign key
+			/// </summary>
+			const std::string& getReferencedColumn() const { return _referencedColumn; }
+
+			/// <summary>
+			/// Sets the table and column referenced by this column
+			/// </summary>
+			/// <param name="tableName">Referenced table name</param>
+			/// <param name="columnName">Referenced column name, usually the primary key</param>
+			void setReference(const std::string& tableName, const std::string& columnName)
+			{
+				_referencedTable = tableName;
+				_referencedColumn = columnName;
+			}
+
 			/// <summary>
 			/// Sets getter method for getting column data based on object
 			/// </summary>
@@ -15,6 +15,27 @@ namespace carousel
 		/// </summary>
 		static const int PK_INDEX{ 0 };
 
+		/// <summary>
+		/// Maximum number of ids contained in a single IN (...) clause. When
+		/// removing entries, each chunk is removed in its own transaction.
+		/// </summary>
+		static const int ID_CHUNK_SIZE{ 500 };
+
+		/// <summary>
+		/// Default number of primary key values reserved at once by the IdAllocator
+		/// </summary>
+		static const int ID_RESERVATION_SIZE{ 1000 };
+
+		/// <summary>
+		/// Default number of parents for which child collections are loaded at once
+		/// </summary>
+		static const int LAZY_LOAD_BATCH_SIZE{ 50 };
+
+		/// <summary>
+		/// Default number of child objects that a lazy relationship keeps in memory
+		/// </summary>
+		static const int LAZY_LOAD_MEMORY_BUDGET{ 100000 };
+
 		/// <summary>
 		/// Database contraint types
 		/// </summary>
@@ -23,7 +44,8 @@ namespace carousel
 			COLUMN		= 1 << 0,
 			PRIMARY_KEY = 1 << 1,
 			UNIQUE		= 1 << 2,
-			LAST		= 2,
+			FOREIGN_KEY	= 1 << 3,
+			LAST		= 3,
 			FIRST		= 0,
 		};
 
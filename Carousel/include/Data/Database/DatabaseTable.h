@@ -108,6 +108,25 @@ namespace carousel
 				_columnTypeMap[column->getConstraint()].push_back(column);
 			}
 
+			/// <summary>
+			/// Adds a new foreign key column to this managed data table. Foreign keys describe
+			/// the dependency between tables and are used for removing dependent data.
+			/// </summary>
+			/// <param name="T">Model object</param>
+			/// <param name="R">Output/Input type</param>
+			/// <param name="name">Column name</param>
+			/// <param name="type">Column type</param>
+			/// <param name="getter">Pointer to member for getter method</param>
+			/// <param name="setter">Pointer to member for setter method</param>
+			/// <param name="referencedTable">Name of the parent table</param>
+			/// <param name="referencedColumn">Name of the referenced column in the parent table</param>
+			template<typename T, typename R>
+			void addForeignKey(const std::string& name, const std::string& type, const R& (T::* getter)(), void (T::* setter)(const R&), const std::string& referencedTable, const std::string& referencedColumn = "Id")
+			{
+				addColumn(name, type, getter, setter, DatabaseConstraintType::FOREIGN_KEY);
+				_columns.back()->setReference(referencedTable, referencedColumn);
+			}
+
 			/// <summary>
 			/// Returns primary key column if defined
 			/// </summary>
@@ -77,10 +77,56 @@ namespace carousel
 			virtual void save(IDatabaseObject* object) = 0;
 
 			/// <summary>
-			/// Saves entry
+			/// Saves entries in a single transaction
 			/// </summary>
 			/// <param name="object"></param>
 			virtual void save(std::vector<IDatabaseObject*> object) = 0;
+
+			/// <summary>
+			/// Removes entry and all entries that depend on it (based on the foreign keys).
+			/// </summary>
+			/// <param name="object"></param>
+			virtual void remove(IDatabaseObject* object) = 0;
+
+			/// <summary>
+			/// Removes entries by primary key and all entries that depend on them. Dependent
+			/// data is removed using set based queries, no objects are loaded.
+			/// </summary>
+			/// <param name="tableData">Table that contains the entries</param>
+			/// <param name="ids">Primary key values</param>
+			virtual void remove(DatabaseTable* tableData, const std::vector<int>& ids) = 0;
+
+			/// <summary>
+			/// Reserves a range of primary key values for a table, values in this range are never
+			/// assigned by the database. Used for building object graphs before saving them.
+			/// </summary>
+			/// <param name="tableData">Table for which the range is reserved</param>
+			/// <param name="count">Number of reserved values</param>
+			/// <returns>First value of the reserved range</returns>
+			virtual int reserveIds(DatabaseTable* tableData, int count) = 0;
+
+			/// <summary>
+			/// Creates the summary tables (EquilibriumSummary, PrecipitationSummary) and the triggers
+			/// that update them while result data is inserted, updated or removed. Summaries are only
+			/// maintained for result tables that exist when this method is called.
+			/// </summary>
+			virtual void createSummaryTables() = 0;
+
+			/// <summary>
+			/// Recomputes all summary tables from the result data. Required for result data that
+			/// was inserted before createSummaryTables was called.
+			/// </summary>
+			virtual void rebuildSummaryTables() = 0;
+
+			/// <summary>
+			/// Returns the raw data of all entries where the given column matches any of the values.
+			/// Each row contains the column values in the order defined by the table, which is the
+			/// format expected by IDatabaseObject::load.
+			/// </summary>
+			/// <param name="tableData">Table that contains the entries</param>
+			/// <param name="columnName">Column used for filtering (e.g. foreign key)</param>
+			/// <param name="values">Accepted values for the column</param>
+			virtual std::vector<std::vector<std::string>> getRawData(DatabaseTable* tableData, const std::string& columnName, const std::vector<int>& values) = 0;
 		};
 	}
 }
\ No newline at end of file
@@ -37,6 +37,8 @@ namespace carousel
 			/// <summary>
 			/// Should remove all data that depends on this item. After removing the item
 			/// the dependence is lost and therefore useless.
+			/// Note: Called by IDatabase::remove before removing the entry, data linked by
+			///		  foreign keys is removed by the database and does not need to be handled here.
 			/// </summary>
 			/// <returns></returns>
 			virtual int remove_dependent_data() { return 0; }
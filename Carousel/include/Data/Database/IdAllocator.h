@@ -0,0 +1,104 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <mutex>
+#include "IDatabase.h"
+#include "IDatabaseObject.h"
+#include "DatabaseTable.h"
+#include "DatabaseConstants.h"
+
+namespace carousel
+{
+	namespace data
+	{
+		/// <summary>
+		/// Hands out primary key values before objects are saved (hi/lo allocation). Ranges are
+		/// reserved per table in the database and values are assigned locally, this allows
+		/// building object graphs (e.g. heat treatment and its segments) with their final keys
+		/// and saving them in a single batch.
+		/// </summary>
+		class IdAllocator
+		{
+		private:
+			/// <summary>
+			/// Reserved range of primary key values [next, end)
+			/// </summary>
+			struct IdRange
+			{
+				int next{ 0 };
+				int end{ 0 };
+			};
+
+			/// <summary>
+			/// Reference to database
+			/// </summary>
+			IDatabase& _database;
+
+			/// <summary>
+			/// Number of values reserved at once
+			/// </summary>
+			int _reservationSize;
+
+			/// <summary>
+			/// Reserved ranges (table name, range)
+			/// </summary>
+			std::map<std::string, IdRange> _ranges;
+
+			/// <summary>
+			/// Allocation mutex
+			/// </summary>
+			std::mutex _mutex;
+
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			/// <param name="database">Database implementation</param>
+			/// <param name="reservationSize">Number of values reserved at once</param>
+			IdAllocator(IDatabase& database, int reservationSize = ID_RESERVATION_SIZE)
+				: _database(database), _reservationSize(reservationSize > 0 ? reservationSize : 1)
+			{
+				// Empty
+			}
+
+		public:
+			/// <summary>
+			/// Returns the next primary key value for the table
+			/// </summary>
+			int nextId(DatabaseTable* tableData)
+			{
+				std::lock_guard<std::mutex> guard(_mutex);
+				IdRange& range = _ranges[tableData->getTableName()];
+
+				// Reserve a new range if current one is used up
+				if (range.next >= range.end)
+				{
+					range.next = _database.reserveIds(tableData, _reservationSize);
+					range.end = range.next + _reservationSize;
+				}
+
+				return range.next++;
+			}
+
+			/// <summary>
+			/// Assigns a primary key value to the object if it does not have one yet.
+			/// Returns the primary key value of the object.
+			/// </summary>
+			int assignId(IDatabaseObject* object)
+			{
+				DatabaseTable& table = object->get_table_structure();
+				DatabaseColumn* primaryKey = table.getPrimaryKey();
+
+				int id = carousel::helpers::converters::convertFromString<int>(primaryKey->getValue(object));
+				if (id == DEFAULT_ID)
+				{
+					id = nextId(&table);
+					primaryKey->setValue(object, std::to_string(id));
+				}
+
+				return id;
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <list>
+#include <memory>
+#include <functional>
+#include <type_traits>
+#include "IDatabase.h"
+#include "IDatabaseObject.h"
+#include "DatabaseConstants.h"
+#include "../../Helpers/Converters.h"
+
+namespace carousel
+{
+	namespace data
+	{
+		/// <summary>
+		/// Relationship between a parent table and the child objects that reference it by a
+		/// foreign key (e.g. Project -> Case, Case -> ElementComposition). Child collections are
+		/// loaded on first access, together with the collections of the next registered parents
+		/// (single IN (...) query). Loaded collections are released in least recently used order
+		/// when the number of loaded objects exceeds the memory budget.
+		/// </summary>
+		/// <param name="T">Child object, IDatabaseObject with a default constructor</param>
+		template<typename T>
+		class LazyRelationship
+		{
+			static_assert(std::is_base_of_v<IDatabaseObject, T>, "LazyRelationship requires an IDatabaseObject");
+
+		public:
+			/// <summary>
+			/// Child collection of a single parent
+			/// </summary>
+			typedef std::vector<std::shared_ptr<T>> Collection;
+
+		private:
+			/// <summary>
+			/// Reference to database
+			/// </summary>
+			IDatabase& _database;
+
+			/// <summary>
+			/// Foreign key column in the child table that references the parent
+			/// </summary>
+			std::string _foreignKey;
+
+			/// <summary>
+			/// Number of parents loaded per query
+			/// </summary>
+			size_t _batchSize;
+
+			/// <summary>
+			/// Maximum number of child objects kept in memory
+			/// </summary>
+			size_t _memoryBudget;
+
+			/// <summary>
+			/// Registered parents, in order of registration. Parents that follow the
+			/// requested one are loaded in the same batch.
+			/// </summary>
+			std::vector<int> _parentIds;
+
+			/// <summary>
+			/// Index of each registered parent in _parentIds (parent id, index)
+			/// </summary>
+			std::map<int, size_t> _parentIndex;
+
+			/// <summary>
+			/// Loaded collections (parent id, collection)
+			/// </summary>
+			std::map<int, std::shared_ptr<Collection>> _loaded;
+
+			/// <summary>
+			/// Loaded parents, most recently used first
+			/// </summary>
+			std::list<int> _recentlyUsed;
+
+			/// <summary>
+			/// Number of child objects currently loaded
+			/// </summary>
+			size_t _loadedCount{ 0 };
+
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			/// <param name="database">Database implementation</param>
+			/// <param name="foreignKey">Foreign key column in the child table</param>
+			/// <param name="batchSize">Number of parents loaded per query</param>
+			/// <param name="memoryBudget">Maximum number of child objects kept in memory</param>
+			LazyRelationship(IDatabase& database, std::string foreignKey, size_t batchSize = LAZY_LOAD_BATCH_SIZE, size_t memoryBudget = LAZY_LOAD_MEMORY_BUDGET)
+				: _database(database), _foreignKey(std::move(foreignKey)), _batchSize(batchSize > 0 ? batchSize : 1), _memoryBudget(memoryBudget)
+			{
+				// Empty
+			}
+
+		public:
+			/// <summary>
+			/// Registers a parent, collections of registered parents are loaded in batches.
+			/// Register parents in the order they are browsed (e.g. order on screen).
+			/// </summary>
+			void registerParent(int parentId)
+			{
+				if (_parentIndex.count(parentId) == 0)
+				{
+					_parentIndex.emplace(parentId, _parentIds.size());
+					_parentIds.push_back(parentId);
+				}
+			}
+
+			/// <summary>
+			/// Returns the child collection of a parent, loads it if necessary. The returned
+			/// collection stays valid even if the relationship releases it afterwards.
+			/// </summary>
+			std::shared_ptr<Collection> get(int parentId)
+			{
+				if (_loaded.count(parentId) == 0)
+				{
+					loadBatch(parentId);
+				}
+
+				touch(parentId);
+				enforceBudget(parentId);
+				return _loaded.at(parentId);
+			}
+
+			/// <summary>
+			/// Returns true if the collection of the parent is currently in memory
+			/// </summary>
+			bool isLoaded(int parentId) const
+			{
+				return _loaded.count(parentId) > 0;
+			}
+
+			/// <summary>
+			/// Releases the collection of a parent, it is loaded again on next access
+			/// </summary>
+			void release(int parentId)
+			{
+				auto entry = _loaded.find(parentId);
+				if (entry == _loaded.end()) return;
+
+				_loadedCount -= entry->second->size();
+				_loaded.erase(entry);
+				_recentlyUsed.remove(parentId);
+			}
+
+			/// <summary>
+			/// Releases all loaded collections
+			/// </summary>
+			void releaseAll()
+			{
+				_loaded.clear();
+				_recentlyUsed.clear();
+				_loadedCount = 0;
+			}
+
+			/// <summary>
+			/// Returns the number of child objects currently in memory
+			/// </summary>
+			size_t loadedCount() const
+			{
+				return _loadedCount;
+			}
+
+		private:
+			/// <summary>
+			/// Loads the collection of the parent and of the next registered parents that are
+			/// not loaded, up to the batch size.
+			/// </summary>
+			void loadBatch(int parentId)
+			{
+				registerParent(parentId);
+
+				// Parents contained in this batch
+				std::vector<int> batch{ parentId };
+				for (size_t i = _parentIndex.at(parentId) + 1; i < _parentIds.size() && batch.size() < _batchSize; i++)
+				{
+					if (_loaded.count(_parentIds[i]) == 0) batch.push_back(_parentIds[i]);
+				}
+
+				// Parents without children still get an (empty) collection
+				for (int id : batch)
+				{
+					_loaded.emplace(id, std::make_shared<Collection>());
+				}
+
+				// Load and group children by parent
+				T prototype;
+				DatabaseTable& table = prototype.get_table_structure();
+				DatabaseColumn* foreignKey = table[_foreignKey];
+
+				std::vector<std::vector<std::string>> rawData = _database.getRawData(&table, _foreignKey, batch);
+				for (auto& row : rawData)
+				{
+					std::shared_ptr<T> child = std::make_shared<T>();
+					if (child->load(row) != 0) continue;
+
+					int childParentId = carousel::helpers::converters::convertFromString<int>(foreignKey->getValue(child.get()));
+					auto entry = _loaded.find(childParentId);
+					if (entry != _loaded.end())
+					{
+						entry->second->push_back(std::move(child));
+						_loadedCount++;
+					}
+				}
+
+				// Prefetched parents are less recent than the requested one
+				for (auto it = batch.rbegin(); it != batch.rend(); ++it)
+				{
+					if (*it != parentId) touch(*it);
+				}
+			}
+
+			/// <summary>
+			/// Marks the parent as most recently used
+			/// </summary>
+			void touch(int parentId)
+			{
+				_recentlyUsed.remove(parentId);
+				_recentlyUsed.push_front(parentId);
+			}
+
+			/// <summary>
+			/// Releases least recently used collections until the memory budget is met.
+			/// The collection of keepId is never released.
+			/// </summary>
+			void enforceBudget(int keepId)
+			{
+				auto it = _recentlyUsed.end();
+				while (_loadedCount > _memoryBudget && it != _recentlyUsed.begin())
+				{
+					--it;
+					if (*it == keepId) continue;
+
+					auto entry = _loaded.find(*it);
+					_loadedCount -= entry->second->size();
+					_loaded.erase(entry);
+					it = _recentlyUsed.erase(it);
+				}
+			}
+		};
+
+		/// <summary>
+		/// Child collection owned by a parent object, loaded through a shared LazyRelationship
+		/// on first access.
+		/// </summary>
+		/// <param name="T">Child object</param>
+		template<typename T>
+		class LazyCollection
+		{
+		private:
+			/// <summary>
+			/// Relationship used for loading
+			/// </summary>
+			LazyRelationship<T>& _relationship;
+
+			/// <summary>
+			/// Returns the id of the parent object
+			/// </summary>
+			std::function<int()> _parentId;
+
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			/// <param name="relationship">Shared relationship</param>
+			/// <param name="parentId">Function that returns the parent id</param>
+			LazyCollection(LazyRelationship<T>& relationship, std::function<int()> parentId)
+				: _relationship(relationship), _parentId(std::move(parentId))
+			{
+				// Empty
+			}
+
+			/// <summary>
+			/// Returns the collection, loads it on first access
+			/// </summary>
+			std::shared_ptr<typename LazyRelationship<T>::Collection> get()
+			{
+				return _relationship.get(_parentId());
+			}
+
+			/// <summary>
+			/// Returns true if the collection is in memory
+			/// </summary>
+			bool isLoaded() const
+			{
+				return _relationship.isLoaded(_parentId());
+			}
+
+			/// <summary>
+			/// Releases the collection
+			/// </summary>
+			void release()
+			{
+				_relationship.release(_parentId());
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <map>
 #include <sqlite3.h>
 #include "IDatabase.h"
 #include "DatabaseTable.h"
@@ -22,6 +23,27 @@ namespace carousel
 		class Sqlite3Database : public IDatabase
 		{
 		private:
+			/// <summary>
+			/// Table that references another table through a foreign key
+			/// </summary>
+			struct DependentTable
+			{
+				/// <summary>
+				/// Name of the dependent table
+				/// </summary>
+				std::string tableName;
+
+				/// <summary>
+				/// Foreign key column in the dependent table
+				/// </summary>
+				std::string foreignKey;
+
+				/// <summary>
+				/// Primary key column of the dependent table
+				/// </summary>
+				std::string primaryKey;
+			};
+
 			/// <summary>
 			/// SQLite3 object
 			/// </summary>
@@ -52,13 +74,30 @@ namespace carousel
 			virtual void dropTable(DatabaseTable* tableData) override;
 			virtual void save(IDatabaseObject* object) override;
 			virtual void save(std::vector<IDatabaseObject*> object) override;
+			virtual void remove(IDatabaseObject* object) override;
+			virtual void remove(DatabaseTable* tableData, const std::vector<int>& ids) override;
+			virtual int reserveIds(DatabaseTable* tableData, int count) override;
+			virtual void createSummaryTables() override;
+			virtual void rebuildSummaryTables() override;
+			virtual std::vector<std::vector<std::string>> getRawData(DatabaseTable* tableData, const std::string& columnName, const std::vector<int>& values) override;
 
 		private:
+			/// <summary>
+			/// Inserts or updates entry, the caller is responsible for the transaction
+			/// </summary>
+			void saveEntry(IDatabaseObject* object);
+
 			/// <summary>
 			/// Returns query for inserting a new entry
 			/// </summary>
 			std::string getInsertQuery(DatabaseTable* const tableData, IDatabaseObject* object);
 
+			/// <summary>
+			/// Returns query for inserting an entry with an assigned primary key, or
+			/// updating it if the primary key is already contained in the database
+			/// </summary>
+			std::string getUpsertQuery(DatabaseTable* const tableData, IDatabaseObject* object);
+
 			/// <summary>
 			/// Returns query for updating an entry
 			/// </summary>
@@ -82,6 +121,38 @@ namespace carousel
 			/// </summary>
 			int getCountForUniqueConstraint(DatabaseTable* const tableData, IDatabaseObject* object);
 
+			/// <summary>
+			/// Executes a query that does not return any data
+			/// </summary>
+			void executeQuery(const std::string& query);
+
+			/// <summary>
+			/// Executes query and returns the first column of each row as an integer
+			/// </summary>
+			std::vector<int> getIdList(const std::string& query);
+
+			/// <summary>
+			/// Returns the dependency graph of the database (table name, dependent tables)
+			/// based on the foreign keys defined in the schema.
+			/// </summary>
+			std::map<std::string, std::vector<DependentTable>> getDependencyGraph();
+
+			/// <summary>
+			/// Removes all entries that depend on the given ids, children are removed before
+			/// their parents. Tables contained in path are skipped to avoid circular references.
+			/// </summary>
+			void removeDependentData(const std::map<std::string, std::vector<DependentTable>>& graph, const std::string& tableName, const std::vector<int>& ids, std::vector<std::string>& path);
+
+			/// <summary>
+			/// Returns true if the database contains the table
+			/// </summary>
+			bool containsTable(const std::string& tableName);
+
+			/// <summary>
+			/// Returns ids as a comma separated list, used for IN (...) clauses
+			/// </summary>
+			static std::string to_id_list(std::vector<int>::const_iterator first, std::vector<int>::const_iterator last);
+
 			/// <summary>
 			/// Puts string into database format depending on the given type
 			/// </summary>
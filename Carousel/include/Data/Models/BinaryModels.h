@@ -0,0 +1,668 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <type_traits>
+#include "../SharedTypes/carouselModels.h"
+#include "../../Helpers/BinaryStream.h"
+#include "../../Exceptions/SerializationException.h"
+
+namespace carousel
+{
+	namespace data
+	{
+		/// <summary>
+		/// Lists the attributes of a data model (carouselModels) in schema order. Specialized for each
+		/// model, update the specialization when the schema changes. New attributes must be appended,
+		/// the position of an attribute is its identifier in the binary format.
+		/// </summary>
+		template<typename T>
+		struct BinaryModelFields;
+
+		/// <summary>
+		/// Binary fields of ActivePhasesModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::ActivePhasesModel>
+		{
+			static constexpr const char* Name{ "ActivePhasesModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.IDProject());
+				visitor(model.IDPhase());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of ActivePhasesConfigurationModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::ActivePhasesConfigurationModel>
+		{
+			static constexpr const char* Name{ "ActivePhasesConfigurationModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.IDProject());
+				visitor(model.StartTemp());
+				visitor(model.EndTemp());
+				visitor(model.StepSize());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of ActivePhasesElementCompositionModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::ActivePhasesElementCompositionModel>
+		{
+			static constexpr const char* Name{ "ActivePhasesElementCompositionModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.IDProject());
+				visitor(model.IDElement());
+				visitor(model.Value());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of CALPHADDatabaseModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::CALPHADDatabaseModel>
+		{
+			static constexpr const char* Name{ "CALPHADDatabaseModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.IDProject());
+				visitor(model.Thermodynamic());
+				visitor(model.Physical());
+				visitor(model.Mobility());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of CaseModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::CaseModel>
+		{
+			static constexpr const char* Name{ "CaseModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.IDProject());
+				visitor(model.IDGroup());
+				visitor(model.Name());
+				visitor(model.Script());
+				visitor(model.Date());
+				visitor(model.PosX());
+				visitor(model.PosY());
+				visitor(model.PosZ());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of ElementModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::ElementModel>
+		{
+			static constexpr const char* Name{ "ElementModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.Name());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of ElementCompositionModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::ElementCompositionModel>
+		{
+			static constexpr const char* Name{ "ElementCompositionModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.IDCase());
+				visitor(model.IDElement());
+				visitor(model.TypeComposition());
+				visitor(model.Value());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of EquilibriumConfigurationModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::EquilibriumConfigurationModel>
+		{
+			static constexpr const char* Name{ "EquilibriumConfigurationModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.IDCase());
+				visitor(model.Temperature());
+				visitor(model.StartTemperature());
+				visitor(model.EndTemperature());
+				visitor(model.TemperatureType());
+				visitor(model.StepSize());
+				visitor(model.Pressure());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of EquilibriumPhaseFractionModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::EquilibriumPhaseFractionModel>
+		{
+			static constexpr const char* Name{ "EquilibriumPhaseFractionModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.IDCase());
+				visitor(model.Temperature());
+				visitor(model.Value());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of HeatTreatmentModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::HeatTreatmentModel>
+		{
+			static constexpr const char* Name{ "HeatTreatmentModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.IDCase());
+				visitor(model.Name());
+				visitor(model.MaxTemperatureStep());
+				visitor(model.IDPrecipitationDomain());
+				visitor(model.StartTemperature());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of HeatTreatmentProfileModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::HeatTreatmentProfileModel>
+		{
+			static constexpr const char* Name{ "HeatTreatmentProfileModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.IDHeatTreatment());
+				visitor(model.Time());
+				visitor(model.Temperature());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of HeatTreatmentSegmentModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::HeatTreatmentSegmentModel>
+		{
+			static constexpr const char* Name{ "HeatTreatmentSegmentModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.StepIndex());
+				visitor(model.IDHeatTreatment());
+				visitor(model.IDPrecipitationDomain());
+				visitor(model.EndTemperature());
+				visitor(model.TemperatureGradient());
+				visitor(model.Duration());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of PhaseModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::PhaseModel>
+		{
+			static constexpr const char* Name{ "PhaseModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.Name());
+				visitor(model.DBType());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of PrecipitationSimulationDataModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::PrecipitationSimulationDataModel>
+		{
+			static constexpr const char* Name{ "PrecipitationSimulationDataModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.IDPrecipitationPhase());
+				visitor(model.IDHeatTreatment());
+				visitor(model.Time());
+				visitor(model.PhaseFraction());
+				visitor(model.NumberDensity());
+				visitor(model.MeanRadius());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of PrecipitationDomainModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::PrecipitationDomainModel>
+		{
+			static constexpr const char* Name{ "PrecipitationDomainModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.IDCase());
+				visitor(model.Name());
+				visitor(model.IDPhase());
+				visitor(model.InitialGrainDiameter());
+				visitor(model.EquilibriumDiDe());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of PrecipitationPhaseModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::PrecipitationPhaseModel>
+		{
+			static constexpr const char* Name{ "PrecipitationPhaseModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.IDCase());
+				visitor(model.IDPhase());
+				visitor(model.NumberSizeClasses());
+				visitor(model.Name());
+				visitor(model.NucleationSites());
+				visitor(model.IDPrecipitationDomain());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of ProjectModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::ProjectModel>
+		{
+			static constexpr const char* Name{ "ProjectModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.Name());
+				visitor(model.ApiName());
+				visitor(model.SoftwareName());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of ScheilConfigurationModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::ScheilConfigurationModel>
+		{
+			static constexpr const char* Name{ "ScheilConfigurationModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.IDCase());
+				visitor(model.StartTemperature());
+				visitor(model.EndTemperature());
+				visitor(model.StepSize());
+				visitor(model.DependentPhase());
+				visitor(model.MinimumLiquidFraction());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of ScheilCumulativeFractionModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::ScheilCumulativeFractionModel>
+		{
+			static constexpr const char* Name{ "ScheilCumulativeFractionModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.IDCase());
+				visitor(model.IDPhase());
+				visitor(model.TypeComposition());
+				visitor(model.Temperature());
+				visitor(model.Value());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of ScheilPhaseFractionModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::ScheilPhaseFractionModel>
+		{
+			static constexpr const char* Name{ "ScheilPhaseFractionModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.IDCase());
+				visitor(model.IDPhase());
+				visitor(model.TypeComposition());
+				visitor(model.Temperature());
+				visitor(model.Value());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of SelectedElementsModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::SelectedElementsModel>
+		{
+			static constexpr const char* Name{ "SelectedElementsModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.IDProject());
+				visitor(model.IDElement());
+				visitor(model.IsReferenceElement());
+			}
+		};
+
+		/// <summary>
+		/// Binary fields of SelectedPhasesModel
+		/// </summary>
+		template<>
+		struct BinaryModelFields<carousel::data::SelectedPhasesModel>
+		{
+			static constexpr const char* Name{ "SelectedPhasesModel" };
+
+			template<typename M, typename V>
+			static void visit(M& model, V& visitor)
+			{
+				visitor(model.Id());
+				visitor(model.IDCase());
+				visitor(model.IDPhase());
+			}
+		};
+
+		/// <summary>
+		/// Binary format version, stored in the header
+		/// </summary>
+		static inline const uint8_t BinaryModelVersion{ 1 };
+
+		/// <summary>
+		/// Identifies streams written by BinaryModelWriter
+		/// </summary>
+		static inline const char BinaryModelMagic[3]{ 'C', 'B', 'M' };
+
+		/// <summary>
+		/// Writes a sequence of data models in compact binary form. Each model is stored as a bit mask of
+		/// the present attributes followed by their values, no text formatting is involved.
+		/// </summary>
+		/// <param name="T">Data model from carouselModels</param>
+		template<typename T>
+		class BinaryModelWriter
+		{
+		private:
+			/// <summary>
+			/// Collects the present attributes
+			/// </summary>
+			struct MaskVisitor
+			{
+				uint64_t mask{ 0 };
+				size_t index{ 0 };
+
+				template<typename O>
+				void operator()(const O& attribute)
+				{
+					if (attribute.present()) mask |= uint64_t{ 1 } << index;
+					index++;
+				}
+			};
+
+			/// <summary>
+			/// Writes the present attributes
+			/// </summary>
+			struct ValueVisitor
+			{
+				carousel::helpers::binary::BinaryWriter& writer;
+
+				template<typename O>
+				void operator()(const O& attribute)
+				{
+					if (!attribute.present()) return;
+
+					using Value = std::decay_t<decltype(attribute.get())>;
+					if constexpr (std::is_integral_v<Value>) writer.writeInt(attribute.get());
+					else if constexpr (std::is_floating_point_v<Value>) writer.writeDouble(attribute.get());
+					else writer.writeString(attribute.get());
+				}
+			};
+
+			/// <summary>
+			/// Binary writer
+			/// </summary>
+			carousel::helpers::binary::BinaryWriter _writer;
+
+		public:
+			/// <summary>
+			/// Constructor, writes the stream header
+			/// </summary>
+			BinaryModelWriter(std::ostream& stream) : _writer(stream)
+			{
+				_writer.writeBytes(BinaryModelMagic, sizeof(BinaryModelMagic));
+				_writer.writeBytes(reinterpret_cast<const char*>(&BinaryModelVersion), 1);
+				_writer.writeString(BinaryModelFields<T>::Name);
+			}
+
+			/// <summary>
+			/// Writes model
+			/// </summary>
+			void write(const T& model)
+			{
+				MaskVisitor maskVisitor;
+				BinaryModelFields<T>::visit(model, maskVisitor);
+				_writer.writeVarint(maskVisitor.mask);
+
+				ValueVisitor valueVisitor{ _writer };
+				BinaryModelFields<T>::visit(model, valueVisitor);
+			}
+
+			/// <summary>
+			/// Writes all models
+			/// </summary>
+			void write(const std::vector<T>& models)
+			{
+				for (const T& model : models)
+				{
+					write(model);
+				}
+			}
+		};
+
+		/// <summary>
+		/// Reads models written by BinaryModelWriter one at a time, memory use does not depend on
+		/// the number of models in the stream.
+		/// </summary>
+		/// <param name="T">Data model from carouselModels</param>
+		template<typename T>
+		class BinaryModelReader
+		{
+		private:
+			/// <summary>
+			/// Reads the present attributes and clears the missing ones
+			/// </summary>
+			struct ValueVisitor
+			{
+				carousel::helpers::binary::BinaryReader& reader;
+				uint64_t mask;
+				size_t index{ 0 };
+
+				template<typename O>
+				void operator()(O& attribute)
+				{
+					if ((mask & (uint64_t{ 1 } << index++)) == 0)
+					{
+						attribute.reset();
+						return;
+					}
+
+					using Value = std::decay_t<decltype(attribute.get())>;
+					if constexpr (std::is_integral_v<Value>) attribute.set(static_cast<Value>(reader.readInt()));
+					else if constexpr (std::is_floating_point_v<Value>) attribute.set(reader.readDouble());
+					else attribute.set(Value(reader.readString()));
+				}
+			};
+
+			/// <summary>
+			/// Binary reader
+			/// </summary>
+			carousel::helpers::binary::BinaryReader _reader;
+
+		public:
+			/// <summary>
+			/// Constructor, reads and checks the stream header
+			/// </summary>
+			BinaryModelReader(std::istream& stream) : _reader(stream)
+			{
+				char magic[sizeof(BinaryModelMagic)];
+				uint8_t version{ 0 };
+				_reader.readBytes(magic, sizeof(magic));
+				_reader.readBytes(reinterpret_cast<char*>(&version), 1);
+
+				if (std::string(magic, sizeof(magic)) != std::string(BinaryModelMagic, sizeof(BinaryModelMagic)) || version != BinaryModelVersion)
+				{
+					throw carousel::exceptions::SerializationException("BinaryModelReader: unknown format");
+				}
+
+				std::string name = _reader.readString();
+				if (name != BinaryModelFields<T>::Name)
+				{
+					throw carousel::exceptions::SerializationException("BinaryModelReader: expected " + std::string(BinaryModelFields<T>::Name) + " but stream contains " + name);
+				}
+			}
+
+			/// <summary>
+			/// Reads next model, returns false if the stream contains no more models
+			/// </summary>
+			bool read(T& model)
+			{
+				if (_reader.atEnd()) return false;
+
+				ValueVisitor visitor{ _reader, _reader.readVarint() };
+				BinaryModelFields<T>::visit(model, visitor);
+
+				// Attributes unknown to this version
+				if ((visitor.mask >> visitor.index) != 0)
+				{
+					throw carousel::exceptions::SerializationException("BinaryModelReader: unknown attributes in " + std::string(BinaryModelFields<T>::Name));
+				}
+
+				return true;
+			}
+
+			/// <summary>
+			/// Reads all remaining models
+			/// </summary>
+			std::vector<T> readAll()
+			{
+				std::vector<T> models;
+				T model;
+				while (read(model))
+				{
+					models.push_back(model);
+				}
+
+				return models;
+			}
+		};
+
+		/// <summary>
+		/// Serializes model to a binary string
+		/// </summary>
+		template<typename T>
+		std::string toBinary(const T& model)
+		{
+			std::ostringstream stream;
+			BinaryModelWriter<T>(stream).write(model);
+			return stream.str();
+		}
+
+		/// <summary>
+		/// Deserializes model from a binary string created by toBinary
+		/// </summary>
+		template<typename T>
+		T fromBinary(const std::string& data)
+		{
+			std::istringstream stream(data);
+			BinaryModelReader<T> reader(stream);
+
+			T model;
+			if (!reader.read(model))
+			{
+				throw carousel::exceptions::SerializationException("fromBinary: no model contained in data");
+			}
+
+			return model;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <string>
+#include "../Database/IDatabaseObject.h"
+#include "../Database/DatabaseColumn.h"
+#include "../Database/DatabaseTable.h"
+#include "../Database/DatabaseConstants.h"
+
+namespace carousel
+{
+	namespace data
+	{
+		/// <summary>
+		/// Per case summary of the equilibrium results (EquilibriumPhaseFractionModel). Entries are
+		/// maintained by the database while results change, see IDatabase::createSummaryTables.
+		/// </summary>
+		class EquilibriumSummary : public carousel::data::IDatabaseObject
+		{
+		public:
+			/// <summary>
+			/// Table that contains the summarized data
+			/// </summary>
+			static inline const std::string SourceTable{ "EquilibriumPhaseFraction" };
+
+			/// <summary>
+			/// Table referenced by IDCase
+			/// </summary>
+			static inline const std::string CaseTable{ "Case" };
+
+		private:
+			/// <summary>
+			/// Id
+			/// </summary>
+			int _id{ carousel::data::DEFAULT_ID };
+
+			/// <summary>
+			/// Case Id
+			/// </summary>
+			int _idCase{ carousel::data::DEFAULT_ID };
+
+			/// <summary>
+			/// Highest temperature with a phase fraction above zero
+			/// </summary>
+			double _solvusTemperature{ 0.0 };
+
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			EquilibriumSummary() : carousel::data::IDatabaseObject() { }
+
+		public:
+			/// <summary>
+			/// Get Id
+			/// </summary>
+			/// <returns></returns>
+			const int& getId() { return _id; }
+
+			/// <summary>
+			/// Set Id
+			/// </summary>
+			/// <param name="newValue"></param>
+			void setId(const int& newValue) { _id = newValue; }
+
+			/// <summary>
+			/// Get case Id
+			/// </summary>
+			/// <returns></returns>
+			const int& getIDCase() { return _idCase; }
+
+			/// <summary>
+			/// Set case Id
+			/// </summary>
+			/// <param name="newValue"></param>
+			void setIDCase(const int& newValue) { _idCase = newValue; }
+
+			/// <summary>
+			/// Get solvus temperature
+			/// </summary>
+			/// <returns></returns>
+			const double& getSolvusTemperature() { return _solvusTemperature; }
+
+			/// <summary>
+			/// Set solvus temperature
+			/// </summary>
+			/// <param name="newValue"></param>
+			void setSolvusTemperature(const double& newValue) { _solvusTemperature = newValue; }
+
+		public: // IDatabaseObject implementation
+
+			virtual int load(std::vector<std::string>& rawData) override
+			{
+				setId(carousel::data::DEFAULT_ID);
+				if (rawData.size() < get_table_structure().size()) return 1;
+				setId(std::stoi(rawData[0]));
+				setIDCase(std::stoi(rawData[1]));
+				setSolvusTemperature(std::stod(rawData[2]));
+
+				return 0;
+			}
+
+			virtual carousel::data::DatabaseTable& get_table_structure() override
+			{
+				static carousel::data::DatabaseTable table("EquilibriumSummary");
+				static bool initialized = false;
+
+				if (!initialized)
+				{
+					table.addColumn("Id", typeid(int).name(), &EquilibriumSummary::getId, &EquilibriumSummary::setId, carousel::data::DatabaseConstraintType::PRIMARY_KEY);
+					table.addForeignKey("IDCase", typeid(int).name(), &EquilibriumSummary::getIDCase, &EquilibriumSummary::setIDCase, CaseTable);
+					table.addColumn("SolvusTemperature", typeid(double).name(), &EquilibriumSummary::getSolvusTemperature, &EquilibriumSummary::setSolvusTemperature, carousel::data::DatabaseConstraintType::COLUMN);
+					initialized = true;
+				}
+
+				return table;
+			}
+		};
+	}
+}
\ No newline at end of file
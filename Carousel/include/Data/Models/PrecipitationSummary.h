@@ -0,0 +1,182 @@
+#pragma once
+
+#include <string>
+#include "../Database/IDatabaseObject.h"
+#include "../Database/DatabaseColumn.h"
+#include "../Database/DatabaseTable.h"
+#include "../Database/DatabaseConstants.h"
+
+namespace carousel
+{
+	namespace data
+	{
+		/// <summary>
+		/// Summary of the precipitation results (PrecipitationSimulationDataModel) for each precipitation
+		/// phase and heat treatment. Entries are maintained by the database while results change,
+		/// see IDatabase::createSummaryTables.
+		/// </summary>
+		class PrecipitationSummary : public carousel::data::IDatabaseObject
+		{
+		public:
+			/// <summary>
+			/// Table that contains the summarized data
+			/// </summary>
+			static inline const std::string SourceTable{ "PrecipitationSimulationData" };
+
+			/// <summary>
+			/// Table referenced by IDPrecipitationPhase
+			/// </summary>
+			static inline const std::string PrecipitationPhaseTable{ "PrecipitationPhase" };
+
+			/// <summary>
+			/// Table referenced by IDHeatTreatment
+			/// </summary>
+			static inline const std::string HeatTreatmentTable{ "HeatTreatment" };
+
+		private:
+			/// <summary>
+			/// Id
+			/// </summary>
+			int _id{ carousel::data::DEFAULT_ID };
+
+			/// <summary>
+			/// Precipitation phase Id
+			/// </summary>
+			int _idPrecipitationPhase{ carousel::data::DEFAULT_ID };
+
+			/// <summary>
+			/// Heat treatment Id
+			/// </summary>
+			int _idHeatTreatment{ carousel::data::DEFAULT_ID };
+
+			/// <summary>
+			/// Last simulated time
+			/// </summary>
+			double _finalTime{ 0.0 };
+
+			/// <summary>
+			/// Mean radius at the last simulated time
+			/// </summary>
+			double _finalMeanRadius{ 0.0 };
+
+			/// <summary>
+			/// Highest phase fraction
+			/// </summary>
+			double _peakPhaseFraction{ 0.0 };
+
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			PrecipitationSummary() : carousel::data::IDatabaseObject() { }
+
+		public:
+			/// <summary>
+			/// Get Id
+			/// </summary>
+			/// <returns></returns>
+			const int& getId() { return _id; }
+
+			/// <summary>
+			/// Set Id
+			/// </summary>
+			/// <param name="newValue"></param>
+			void setId(const int& newValue) { _id = newValue; }
+
+			/// <summary>
+			/// Get precipitation phase Id
+			/// </summary>
+			/// <returns></returns>
+			const int& getIDPrecipitationPhase() { return _idPrecipitationPhase; }
+
+			/// <summary>
+			/// Set precipitation phase Id
+			/// </summary>
+			/// <param name="newValue"></param>
+			void setIDPrecipitationPhase(const int& newValue) { _idPrecipitationPhase = newValue; }
+
+			/// <summary>
+			/// Get heat treatment Id
+			/// </summary>
+			/// <returns></returns>
+			const int& getIDHeatTreatment() { return _idHeatTreatment; }
+
+			/// <summary>
+			/// Set heat treatment Id
+			/// </summary>
+			/// <param name="newValue"></param>
+			void setIDHeatTreatment(const int& newValue) { _idHeatTreatment = newValue; }
+
+			/// <summary>
+			/// Get last simulated time
+			/// </summary>
+			/// <returns></returns>
+			const double& getFinalTime() { return _finalTime; }
+
+			/// <summary>
+			/// Set last simulated time
+			/// </summary>
+			/// <param name="newValue"></param>
+			void setFinalTime(const double& newValue) { _finalTime = newValue; }
+
+			/// <summary>
+			/// Get mean radius at the last simulated time
+			/// </summary>
+			/// <returns></returns>
+			const double& getFinalMeanRadius() { return _finalMeanRadius; }
+
+			/// <summary>
+			/// Set mean radius at the last simulated time
+			/// </summary>
+			/// <param name="newValue"></param>
+			void setFinalMeanRadius(const double& newValue) { _finalMeanRadius = newValue; }
+
+			/// <summary>
+			/// Get highest phase fraction
+			/// </summary>
+			/// <returns></returns>
+			const double& getPeakPhaseFraction() { return _peakPhaseFraction; }
+
+			/// <summary>
+			/// Set highest phase fraction
+			/// </summary>
+			/// <param name="newValue"></param>
+			void setPeakPhaseFraction(const double& newValue) { _peakPhaseFraction = newValue; }
+
+		public: // IDatabaseObject implementation
+
+			virtual int load(std::vector<std::string>& rawData) override
+			{
+				setId(carousel::data::DEFAULT_ID);
+				if (rawData.size() < get_table_structure().size()) return 1;
+				setId(std::stoi(rawData[0]));
+				setIDPrecipitationPhase(std::stoi(rawData[1]));
+				setIDHeatTreatment(std::stoi(rawData[2]));
+				setFinalTime(std::stod(rawData[3]));
+				setFinalMeanRadius(std::stod(rawData[4]));
+				setPeakPhaseFraction(std::stod(rawData[5]));
+
+				return 0;
+			}
+
+			virtual carousel::data::DatabaseTable& get_table_structure() override
+			{
+				static carousel::data::DatabaseTable table("PrecipitationSummary");
+				static bool initialized = false;
+
+				if (!initialized)
+				{
+					table.addColumn("Id", typeid(int).name(), &PrecipitationSummary::getId, &PrecipitationSummary::setId, carousel::data::DatabaseConstraintType::PRIMARY_KEY);
+					table.addForeignKey("IDPrecipitationPhase", typeid(int).name(), &PrecipitationSummary::getIDPrecipitationPhase, &PrecipitationSummary::setIDPrecipitationPhase, PrecipitationPhaseTable);
+					table.addForeignKey("IDHeatTreatment", typeid(int).name(), &PrecipitationSummary::getIDHeatTreatment, &PrecipitationSummary::setIDHeatTreatment, HeatTreatmentTable);
+					table.addColumn("FinalTime", typeid(double).name(), &PrecipitationSummary::getFinalTime, &PrecipitationSummary::setFinalTime, carousel::data::DatabaseConstraintType::COLUMN);
+					table.addColumn("FinalMeanRadius", typeid(double).name(), &PrecipitationSummary::getFinalMeanRadius, &PrecipitationSummary::setFinalMeanRadius, carousel::data::DatabaseConstraintType::COLUMN);
+					table.addColumn("PeakPhaseFraction", typeid(double).name(), &PrecipitationSummary::getPeakPhaseFraction, &PrecipitationSummary::setPeakPhaseFraction, carousel::data::DatabaseConstraintType::COLUMN);
+					initialized = true;
+				}
+
+				return table;
+			}
+		};
+	}
+}
\ No newline at end of file
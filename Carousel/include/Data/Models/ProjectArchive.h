@@ -0,0 +1,133 @@
+#pragma once
+
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <stdexcept>
+#include <xercesc/framework/MemBufInputSource.hpp>
+#include <Poco/DateTime.h>
+#include <Poco/Path.h>
+#include <Poco/StreamCopier.h>
+#include <Poco/Zip/Compress.h>
+#include <Poco/Zip/ZipArchive.h>
+#include <Poco/Zip/ZipStream.h>
+#include "../../Core/BaseTypes/XmlSerializable.h"
+
+namespace carousel
+{
+	namespace data
+	{
+		/// <summary>
+		/// Single file (zip) archive that bundles a project, its configuration file and optionally
+		/// a database snapshot. All entries are deflate compressed.
+		/// </summary>
+		class ProjectArchive
+		{
+		public:
+			/// <summary>
+			/// Archive entry of the project xml
+			/// </summary>
+			static inline const std::string ProjectEntry{ "project.xml" };
+
+			/// <summary>
+			/// Archive entry of the configuration
+			/// </summary>
+			static inline const std::string ConfigurationEntry{ "configuration.xml" };
+
+			/// <summary>
+			/// Archive entry of the database snapshot
+			/// </summary>
+			static inline const std::string DatabaseEntry{ "database.db" };
+
+			/// <summary>
+			/// Writes archive
+			/// </summary>
+			/// <param name="archivePath">full path of the archive</param>
+			/// <param name="project">Project (or any other serializable object)</param>
+			/// <param name="configurationFile">Configuration file</param>
+			/// <param name="databaseFile">Database snapshot, empty if not included. The database must not
+			/// be written to while it is archived.</param>
+			static void save(const std::string& archivePath, carousel::core::XmlSerializable& project, const std::string& configurationFile, const std::string& databaseFile = "")
+			{
+				std::ofstream archive(archivePath, std::ios::binary);
+				if (!archive.is_open()) throw std::runtime_error("ProjectArchive: could not create " + archivePath);
+
+				Poco::Zip::Compress compress(archive, true);
+				Poco::DateTime now;
+
+				std::stringstream projectXml;
+				project.serialize(projectXml);
+				compress.addFile(projectXml, now, Poco::Path(ProjectEntry));
+
+				addFile(compress, configurationFile, ConfigurationEntry, now);
+				if (!databaseFile.empty()) addFile(compress, databaseFile, DatabaseEntry, now);
+
+				compress.close();
+				archive.close();
+				if (archive.fail()) throw std::runtime_error("ProjectArchive: could not write " + archivePath);
+			}
+
+			/// <summary>
+			/// Reads archive, loads the project and extracts the configuration and the database
+			/// snapshot. Returns true if the archive contains a database snapshot.
+			/// </summary>
+			/// <param name="archivePath">full path of the archive</param>
+			/// <param name="project">Project that is loaded</param>
+			/// <param name="configurationFile">Target of the configuration file</param>
+			/// <param name="databaseFile">Target of the database snapshot, empty to skip</param>
+			static bool load(const std::string& archivePath, carousel::core::XmlSerializable& project, const std::string& configurationFile, const std::string& databaseFile = "")
+			{
+				std::ifstream archive(archivePath, std::ios::binary);
+				if (!archive.is_open()) throw std::runtime_error("ProjectArchive: could not open " + archivePath);
+
+				Poco::Zip::ZipArchive entries(archive);
+
+				// Project
+				std::ostringstream projectXml;
+				extract(archive, entries, ProjectEntry, projectXml);
+				std::string xml = projectXml.str();
+				xercesc::MemBufInputSource source(reinterpret_cast<const XMLByte*>(xml.data()), xml.size(), archivePath.c_str());
+				project.loadFromXml(source);
+
+				// Configuration
+				std::ofstream configuration(configurationFile, std::ios::binary);
+				extract(archive, entries, ConfigurationEntry, configuration);
+
+				// Database
+				bool hasDatabase = entries.findHeader(DatabaseEntry) != entries.headerEnd();
+				if (hasDatabase && !databaseFile.empty())
+				{
+					std::ofstream database(databaseFile, std::ios::binary);
+					extract(archive, entries, DatabaseEntry, database);
+				}
+
+				return hasDatabase;
+			}
+
+		private:
+			/// <summary>
+			/// Adds file to the archive
+			/// </summary>
+			static void addFile(Poco::Zip::Compress& compress, const std::string& filepath, const std::string& entry, const Poco::DateTime& date)
+			{
+				std::ifstream file(filepath, std::ios::binary);
+				if (!file.is_open()) throw std::runtime_error("ProjectArchive: could not open " + filepath);
+
+				compress.addFile(file, date, Poco::Path(entry));
+			}
+
+			/// <summary>
+			/// Inflates entry into output
+			/// </summary>
+			static void extract(std::istream& archive, const Poco::Zip::ZipArchive& entries, const std::string& entry, std::ostream& output)
+			{
+				auto header = entries.findHeader(entry);
+				if (header == entries.headerEnd()) throw std::runtime_error("ProjectArchive: missing entry " + entry);
+
+				Poco::Zip::ZipInputStream input(archive, header->second);
+				Poco::StreamCopier::copyStream(input, output);
+				if (!output) throw std::runtime_error("ProjectArchive: could not extract " + entry);
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <xercesc/dom/DOMDocument.hpp>
+#include <xercesc/sax/SAXParseException.hpp>
+#include "../SharedTypes/carouselModels.h"
+#include "../../Core/BaseTypes/XmlParserPool.h"
+#include "../../Core/BaseTypes/XmlTranscoder.h"
+#include "../../Core/BaseTypes/XmlCompression.h"
+
+namespace carousel
+{
+	namespace data
+	{
+		/// <summary>
+		/// Loads xsd data models (carouselModels) using the pooled, arena backed parsers instead of
+		/// creating a new parser and document on the default heap for every file. Files are memory
+		/// mapped and parsed without intermediate copies, gzip compressed files are inflated while parsing.
+		/// </summary>
+		class XmlModelLoader
+		{
+		public:
+			/// <summary>
+			/// Generated parse function that reads a model from a DOM document (e.g. carousel::data::CaseModel_)
+			/// </summary>
+			template<typename T>
+			using ParseFunction = std::unique_ptr<T>(*)(const xercesc::DOMDocument&, xml_schema::flags, const xml_schema::properties&);
+
+			/// <summary>
+			/// Loads model from file. The DOM is released as soon as the model is built, do not pass
+			/// xml_schema::flags::keep_dom.
+			/// </summary>
+			/// <example>
+			/// auto caseModel = XmlModelLoader::load("case.xml", &carousel::data::CaseModel_);
+			/// </example>
+			/// <param name="filepath">full path</param>
+			/// <param name="parseFunction">Generated parse function of the model</param>
+			/// <param name="flags">xsd parsing flags</param>
+			template<typename T>
+			static std::unique_ptr<T> load(const std::string& filepath, ParseFunction<T> parseFunction, xml_schema::flags flags = 0)
+			{
+				// Parser and document are returned to the pool when leaving this scope
+				carousel::core::XmlParserPool::PooledParser parser = carousel::core::XmlParserPool::namespaceInstance().acquire();
+
+				try
+				{
+					std::unique_ptr<xercesc::InputSource> source = carousel::core::XmlCompression::openInputSource(filepath);
+					parser->parse(*source);
+				}
+				catch (const xercesc::SAXParseException& e)
+				{
+					throw std::runtime_error("SAXParseException: " + carousel::core::XmlTranscoder::local().toString(e.getMessage()));
+				}
+				catch (const xercesc::XMLException& e)
+				{
+					throw std::runtime_error("XMLException: " + carousel::core::XmlTranscoder::local().toString(e.getMessage()));
+				}
+
+				xercesc::DOMDocument* document = parser->getDocument();
+				if (document == nullptr || parser->getErrorCount() > 0)
+				{
+					throw std::runtime_error("XmlModelLoader could not parse " + filepath);
+				}
+
+				return parseFunction(*document, flags, xml_schema::properties());
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+#include <exception>
+#include <string>
+
+namespace carousel
+{
+	namespace exceptions
+	{
+		/// <summary>
+		/// Exception thrown when serialized data can't be read (truncated or wrong format)
+		/// </summary>
+		class SerializationException : public std::exception
+		{
+		private:
+			std::string _message{ "" };
+
+		public:
+			SerializationException(const std::string& message) : _message(message) {}
+
+			virtual const char* what() const noexcept {
+				return _message.c_str();
+			}
+		};
+	}
+}
\ No newline at end of file
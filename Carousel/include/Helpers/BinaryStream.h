@@ -0,0 +1,214 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include "../Exceptions/SerializationException.h"
+
+namespace carousel
+{
+	namespace helpers
+	{
+		namespace binary
+		{
+			/// <summary>
+			/// Writes values in a compact, platform independent binary format. Integers are written
+			/// as zigzag varints, doubles as 8 little endian bytes and strings length prefixed.
+			/// </summary>
+			class BinaryWriter
+			{
+			private:
+				/// <summary>
+				/// Output stream
+				/// </summary>
+				std::ostream& _stream;
+
+			public:
+				/// <summary>
+				/// Constructor
+				/// </summary>
+				BinaryWriter(std::ostream& stream) : _stream(stream)
+				{
+					// Empty
+				}
+
+				/// <summary>
+				/// Writes unsigned varint (7 bits per byte)
+				/// </summary>
+				void writeVarint(uint64_t value)
+				{
+					char buffer[10];
+					size_t size{ 0 };
+					while (value >= 0x80)
+					{
+						buffer[size++] = static_cast<char>((value & 0x7F) | 0x80);
+						value >>= 7;
+					}
+					buffer[size++] = static_cast<char>(value);
+					_stream.write(buffer, size);
+				}
+
+				/// <summary>
+				/// Writes signed integer, small negative values stay small (zigzag)
+				/// </summary>
+				void writeInt(int64_t value)
+				{
+					writeVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+				}
+
+				/// <summary>
+				/// Writes double without loss of precision
+				/// </summary>
+				void writeDouble(double value)
+				{
+					uint64_t bits;
+					std::memcpy(&bits, &value, sizeof(bits));
+
+					char buffer[8];
+					for (size_t i = 0; i < sizeof(buffer); i++)
+					{
+						buffer[i] = static_cast<char>(bits >> (8 * i));
+					}
+					_stream.write(buffer, sizeof(buffer));
+				}
+
+				/// <summary>
+				/// Writes length prefixed string
+				/// </summary>
+				void writeString(const std::string& value)
+				{
+					writeVarint(value.size());
+					_stream.write(value.data(), value.size());
+				}
+
+				/// <summary>
+				/// Writes raw bytes
+				/// </summary>
+				void writeBytes(const char* data, size_t size)
+				{
+					_stream.write(data, size);
+				}
+			};
+
+			/// <summary>
+			/// Reads values written by BinaryWriter, throws SerializationException if the
+			/// stream ends unexpectedly.
+			/// </summary>
+			class BinaryReader
+			{
+			private:
+				/// <summary>
+				/// Input stream
+				/// </summary>
+				std::istream& _stream;
+
+			public:
+				/// <summary>
+				/// Constructor
+				/// </summary>
+				BinaryReader(std::istream& stream) : _stream(stream)
+				{
+					// Empty
+				}
+
+				/// <summary>
+				/// Returns true if there is no more data to read
+				/// </summary>
+				bool atEnd()
+				{
+					return _stream.peek() == std::istream::traits_type::eof();
+				}
+
+				/// <summary>
+				/// Reads unsigned varint
+				/// </summary>
+				uint64_t readVarint()
+				{
+					uint64_t value{ 0 };
+					for (int shift = 0; shift < 64; shift += 7)
+					{
+						uint8_t byte = static_cast<uint8_t>(readByte());
+						value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+						if ((byte & 0x80) == 0) return value;
+					}
+
+					throw carousel::exceptions::SerializationException("BinaryReader: invalid varint");
+				}
+
+				/// <summary>
+				/// Reads signed integer
+				/// </summary>
+				int64_t readInt()
+				{
+					uint64_t value = readVarint();
+					return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+				}
+
+				/// <summary>
+				/// Reads double
+				/// </summary>
+				double readDouble()
+				{
+					char buffer[8];
+					readBytes(buffer, sizeof(buffer));
+
+					uint64_t bits{ 0 };
+					for (size_t i = 0; i < sizeof(buffer); i++)
+					{
+						bits |= static_cast<uint64_t>(static_cast<uint8_t>(buffer[i])) << (8 * i);
+					}
+
+					double value;
+					std::memcpy(&value, &bits, sizeof(value));
+					return value;
+				}
+
+				/// <summary>
+				/// Reads length prefixed string
+				/// </summary>
+				std::string readString()
+				{
+					uint64_t size = readVarint();
+					std::string value;
+
+					// Read in chunks, a corrupted length must not allocate huge buffers up front
+					char buffer[4096];
+					while (size > 0)
+					{
+						size_t chunk = size < sizeof(buffer) ? static_cast<size_t>(size) : sizeof(buffer);
+						readBytes(buffer, chunk);
+						value.append(buffer, chunk);
+						size -= chunk;
+					}
+
+					return value;
+				}
+
+				/// <summary>
+				/// Reads raw bytes
+				/// </summary>
+				void readBytes(char* data, size_t size)
+				{
+					_stream.read(data, size);
+					if (static_cast<size_t>(_stream.gcount()) != size)
+					{
+						throw carousel::exceptions::SerializationException("BinaryReader: unexpected end of data");
+					}
+				}
+
+			private:
+				/// <summary>
+				/// Reads single byte
+				/// </summary>
+				char readByte()
+				{
+					char byte;
+					readBytes(&byte, 1);
+					return byte;
+				}
+			};
+		}
+	}
+}
\ No newline at end of file
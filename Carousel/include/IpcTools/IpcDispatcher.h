@@ -0,0 +1,236 @@
+#pragma once
+
+#include <string>
+#include <deque>
+#include <map>
+#include <memory>
+#include <future>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+#include "IpcPipeHandler.h"
+#include "IpcEventWaiter.h"
+
+namespace carousel
+{
+	namespace ipcTools
+	{
+		/// <summary>
+		/// Cooperative cancellation of asynchronous commands. Cancelling a command that was not sent
+		/// yet removes it from the queue, cancelling a running command terminates the process.
+		/// </summary>
+		class IpcCancellation
+		{
+		private:
+			/// <summary>
+			/// True once cancelled
+			/// </summary>
+			std::atomic<bool> _cancelled{ false };
+
+			/// <summary>
+			/// Called on cancellation, wakes up the dispatcher
+			/// </summary>
+			std::function<void()> _onCancel;
+
+			/// <summary>
+			/// Guards the callback
+			/// </summary>
+			std::mutex _callbackMutex;
+
+			friend class IpcDispatcher;
+
+		public:
+			/// <summary>
+			/// Requests cancellation
+			/// </summary>
+			void cancel()
+			{
+				_cancelled = true;
+
+				std::function<void()> onCancel;
+				{
+					std::lock_guard<std::mutex> lock(_callbackMutex);
+					onCancel = _onCancel;
+				}
+				if (onCancel) onCancel();
+			}
+
+			/// <summary>
+			/// Returns true if cancellation was requested
+			/// </summary>
+			bool isCancelled() const
+			{
+				return _cancelled;
+			}
+
+		private:
+			/// <summary>
+			/// Sets the cancellation callback
+			/// </summary>
+			void setCallback(std::function<void()> onCancel)
+			{
+				std::lock_guard<std::mutex> lock(_callbackMutex);
+				_onCancel = std::move(onCancel);
+			}
+		};
+
+		/// <summary>
+		/// Drives the asynchronous commands of many IpcPipeHandler sessions from a single thread. Commands
+		/// of a session are sent in order, each one after the previous response was received. Commands are
+		/// written without blocking, a process that stops reading its input only delays its own session.
+		/// A command that misses its deadline or is cancelled while running (also while it is still being
+		/// written) terminates the process, the remaining commands of that session fail.
+		/// A session must not be read or written directly while it has asynchronous commands. Once all of
+		/// its commands completed the session is unregistered and can be used synchronously again.
+		/// </summary>
+		class IpcDispatcher
+		{
+		private:
+			/// <summary>
+			/// Asynchronous command
+			/// </summary>
+			struct Request
+			{
+				std::string command;
+				std::promise<std::string> result;
+				std::chrono::milliseconds timeout;
+				std::chrono::steady_clock::time_point deadline;
+				std::shared_ptr<IpcCancellation> cancellation;
+
+				/// <summary>
+				/// True once writing the command started, the deadline counts from then
+				/// </summary>
+				bool sent{ false };
+
+				/// <summary>
+				/// Number of bytes of the command written so far
+				/// </summary>
+				size_t written{ 0 };
+			};
+
+			/// <summary>
+			/// Session and its commands, the front command is the running one
+			/// </summary>
+			struct Session
+			{
+				IpcPipeHandler* handler;
+				std::deque<Request> requests;
+				uint64_t id;
+
+				/// <summary>
+				/// True while the in pipe is watched because a command is partially written
+				/// </summary>
+				bool writeWatched{ false };
+			};
+
+			/// <summary>
+			/// Sessions (session id, session)
+			/// </summary>
+			std::map<uint64_t, Session> _sessions;
+
+			/// <summary>
+			/// Session ids (handler, session id)
+			/// </summary>
+			std::map<IpcPipeHandler*, uint64_t> _sessionIds;
+
+			/// <summary>
+			/// Next session id
+			/// </summary>
+			uint64_t _nextSessionId{ 1 };
+
+			/// <summary>
+			/// Waits on the sessions
+			/// </summary>
+			IpcEventWaiter _waiter;
+
+			/// <summary>
+			/// Guards the sessions
+			/// </summary>
+			std::mutex _mutex;
+
+			/// <summary>
+			/// Signalled after each dispatcher iteration
+			/// </summary>
+			std::condition_variable _iterationDone;
+
+			/// <summary>
+			/// Number of dispatcher iterations
+			/// </summary>
+			uint64_t _iteration{ 0 };
+
+			/// <summary>
+			/// True once the dispatcher is stopping
+			/// </summary>
+			bool _stopping{ false };
+
+			/// <summary>
+			/// Dispatcher thread
+			/// </summary>
+			std::thread _thread;
+
+		public:
+			/// <summary>
+			/// Constructor, starts the dispatcher thread
+			/// </summary>
+			IpcDispatcher();
+
+			/// <summary>
+			/// Destructor, pending commands fail and the dispatcher thread is joined
+			/// </summary>
+			~IpcDispatcher();
+
+			IpcDispatcher(const IpcDispatcher&) = delete;
+			IpcDispatcher& operator=(const IpcDispatcher&) = delete;
+
+			/// <summary>
+			/// Shared dispatcher, used by IpcPipeHandler::sendAsync
+			/// </summary>
+			static IpcDispatcher& instance()
+			{
+				static IpcDispatcher dispatcher;
+				return dispatcher;
+			}
+
+		public:
+			/// <summary>
+			/// Queues a command. The future holds the response, or an IpcCommunicationException if the
+			/// deadline was missed, the command was cancelled or the process failed.
+			/// </summary>
+			/// <param name="handler">Session, has to outlive its commands or be destroyed (which fails them)</param>
+			/// <param name="command">Command</param>
+			/// <param name="timeout">Time the response may take, counted from the moment the command is sent</param>
+			/// <param name="cancellation">Optional cancellation</param>
+			std::future<std::string> sendAsync(IpcPipeHandler& handler, std::string command, std::chrono::milliseconds timeout, std::shared_ptr<IpcCancellation> cancellation = nullptr);
+
+			/// <summary>
+			/// Removes a session, its pending commands fail. Returns after the dispatcher has stopped using it.
+			/// </summary>
+			void remove(IpcPipeHandler& handler);
+
+			/// <summary>
+			/// Returns the number of commands that have not completed
+			/// </summary>
+			size_t pendingCount();
+
+		private:
+			/// <summary>
+			/// Dispatcher loop
+			/// </summary>
+			void run();
+
+			/// <summary>
+			/// Receives responses, handles deadlines and cancellations and sends the next command.
+			/// Returns false if the session was closed. Called with the lock held.
+			/// </summary>
+			bool update(Session& session, bool readable, std::chrono::steady_clock::time_point now);
+
+			/// <summary>
+			/// Fails all commands of the session and unregisters it. Called with the lock held.
+			/// </summary>
+			void close(Session& session, const std::string& message, bool terminate);
+		};
+	}
+}
\ No newline at end of file
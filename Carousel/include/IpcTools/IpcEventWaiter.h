@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "IpcPipeHandler.h"
+
+#ifdef _WIN32
+#include <mutex>
+#include <utility>
+#endif
+
+namespace carousel
+{
+	namespace ipcTools
+	{
+		/// <summary>
+		/// Waits on the notification handles of many IPC sessions at once (epoll on linux,
+		/// WaitForMultipleObjects on windows). Handles are identified by an id chosen by the caller.
+		/// </summary>
+		class IpcEventWaiter
+		{
+		private:
+#ifdef _WIN32
+			/// <summary>
+			/// Event used to wake up a waiting thread
+			/// </summary>
+			HANDLE _wakeHandle;
+
+			/// <summary>
+			/// Registered handles (handle, id)
+			/// </summary>
+			std::vector<std::pair<HANDLE, uint64_t>> _handles;
+
+			/// <summary>
+			/// Guards the registered handles
+			/// </summary>
+			std::mutex _handlesMutex;
+#elif __unix__
+			/// <summary>
+			/// Epoll instance that watches the registered handles
+			/// </summary>
+			SystemHandle _epollHandle;
+
+			/// <summary>
+			/// Eventfd used to wake up a waiting thread
+			/// </summary>
+			SystemHandle _wakeHandle;
+#endif // OS
+
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			IpcEventWaiter();
+
+			/// <summary>
+			/// Destructor
+			/// </summary>
+			~IpcEventWaiter();
+
+			IpcEventWaiter(const IpcEventWaiter&) = delete;
+			IpcEventWaiter& operator=(const IpcEventWaiter&) = delete;
+
+		public:
+			/// <summary>
+			/// Registers a handle
+			/// </summary>
+			void add(SystemHandle handle, uint64_t id);
+
+			/// <summary>
+			/// Registers a handle that is signalled while it can be written (write end of a pipe on linux,
+			/// event on windows)
+			/// </summary>
+			void addWritable(SystemHandle handle, uint64_t id);
+
+			/// <summary>
+			/// Unregisters a handle
+			/// </summary>
+			void remove(SystemHandle handle);
+
+			/// <summary>
+			/// Waits until a registered handle is signalled, wake is called or the timeout is reached.
+			/// Ids of the signalled handles are added to ready.
+			/// </summary>
+			/// <param name="timeoutMs">Timeout in milliseconds, negative waits without timeout</param>
+			void wait(int timeoutMs, std::vector<uint64_t>& ready);
+
+			/// <summary>
+			/// Wakes up the waiting thread
+			/// </summary>
+			void wake();
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,391 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include "../Callbacks/ProgressUpdateCallback.h"
+#include "../Logging/CarouselLogger.h"
+
+namespace carousel
+{
+	namespace ipcTools
+	{
+		/// <summary>
+		/// Describes the output of a solver for IpcOutputParser
+		/// </summary>
+		struct IpcOutputFormat
+		{
+			/// <summary>
+			/// Lines starting with this prefix report progress, the first number after it is the progress.
+			/// Empty disables progress reports.
+			/// </summary>
+			std::string progressPrefix;
+
+			/// <summary>
+			/// Factor applied to the reported progress (e.g. 100 if the solver reports fractions)
+			/// </summary>
+			double progressScale{ 1.0 };
+
+			/// <summary>
+			/// Lines starting with this prefix begin a table and are its header, the numeric lines that
+			/// follow are its rows. Empty treats every numeric line as a row.
+			/// </summary>
+			std::string tablePrefix;
+
+			/// <summary>
+			/// Column separators
+			/// </summary>
+			std::string separators{ " \t;," };
+
+			/// <summary>
+			/// Minimum time between two progress reports
+			/// </summary>
+			std::chrono::milliseconds progressInterval{ 200 };
+
+			/// <summary>
+			/// Longest line that is kept, longer lines are skipped
+			/// </summary>
+			size_t maxLineLength{ 64 * 1024 };
+		};
+
+		/// <summary>
+		/// Parses solver output while it arrives (e.g. fed by IpcPipeHandler::readStream). Progress lines are
+		/// reported at most once per progress interval, table rows are handed to the row handler one at a
+		/// time. Only the current line is kept, memory does not grow with the length of the output.
+		/// </summary>
+		class IpcOutputParser
+		{
+		public:
+			/// <summary>
+			/// Receives a table row, table is the header line of its table (empty if the format has no table prefix)
+			/// </summary>
+			typedef std::function<void(const std::string& table, const std::vector<double>& columns)> RowHandler;
+
+			/// <summary>
+			/// Receives a progress line and its progress
+			/// </summary>
+			typedef std::function<void(const std::string& message, double progress)> ProgressHandler;
+
+		private:
+			/// <summary>
+			/// Output format
+			/// </summary>
+			IpcOutputFormat _format;
+
+			/// <summary>
+			/// Row handler
+			/// </summary>
+			RowHandler _onRow;
+
+			/// <summary>
+			/// Progress handler
+			/// </summary>
+			ProgressHandler _onProgress;
+
+			/// <summary>
+			/// Incomplete line
+			/// </summary>
+			std::string _line;
+
+			/// <summary>
+			/// True while the rest of a too long line is skipped
+			/// </summary>
+			bool _skipLine{ false };
+
+			/// <summary>
+			/// True while the rows of a table are read
+			/// </summary>
+			bool _inTable{ false };
+
+			/// <summary>
+			/// Header line of the current table
+			/// </summary>
+			std::string _table;
+
+			/// <summary>
+			/// Columns of the current row, reused
+			/// </summary>
+			std::vector<double> _columns;
+
+			/// <summary>
+			/// Progress line that was throttled and not reported yet
+			/// </summary>
+			std::string _pendingProgress;
+
+			/// <summary>
+			/// Progress of the pending progress line
+			/// </summary>
+			double _pendingValue{ 0.0 };
+
+			/// <summary>
+			/// Time of the last progress report
+			/// </summary>
+			std::chrono::steady_clock::time_point _lastReport;
+
+			/// <summary>
+			/// True once progress was reported
+			/// </summary>
+			bool _reported{ false };
+
+			/// <summary>
+			/// Number of rows handed out
+			/// </summary>
+			size_t _rowCount{ 0 };
+
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			/// <param name="format">Output format</param>
+			/// <param name="onRow">Row handler (e.g. an IpcRowEmitter)</param>
+			/// <param name="onProgress">Progress handler, reports through ProgressUpdateCallback if empty</param>
+			IpcOutputParser(IpcOutputFormat format, RowHandler onRow, ProgressHandler onProgress = nullptr) : _format(std::move(format)), _onRow(std::move(onRow)), _onProgress(std::move(onProgress))
+			{
+				if (!_onProgress)
+				{
+					_onProgress = [](const std::string& message, double progress)
+					{
+						std::string callbackData = message;
+						carousel::callbacks::ProgressUpdateCallback::TriggerCallback(callbackData.data(), progress);
+					};
+				}
+			}
+
+		public:
+			/// <summary>
+			/// Parses the next piece of output
+			/// </summary>
+			void feed(const char* data, size_t length)
+			{
+				while (length > 0)
+				{
+					const char* lineEnd = static_cast<const char*>(std::memchr(data, '\n', length));
+					size_t count = lineEnd ? static_cast<size_t>(lineEnd - data) : length;
+
+					if (!_skipLine)
+					{
+						if (_line.length() + count > _format.maxLineLength)
+						{
+							carousel::logging::CarouselLogger::instance().warning("IpcOutputParser - Line exceeds " + std::to_string(_format.maxLineLength) + " bytes and is skipped.");
+							_line.clear();
+							_skipLine = true;
+						}
+						else
+						{
+							_line.append(data, count);
+						}
+					}
+
+					if (!lineEnd) break;
+
+					if (!_skipLine) parseLine();
+					_line.clear();
+					_skipLine = false;
+
+					data += count + 1;
+					length -= count + 1;
+				}
+			}
+
+			/// <summary>
+			/// Parses the next piece of output
+			/// </summary>
+			void feed(const std::string& data)
+			{
+				feed(data.data(), data.length());
+			}
+
+			/// <summary>
+			/// Ends the output of a command: parses the last line, reports throttled progress and closes the table
+			/// </summary>
+			void finish()
+			{
+				if (!_skipLine && !_line.empty()) parseLine();
+				_line.clear();
+				_skipLine = false;
+
+				if (!_pendingProgress.empty()) reportProgress();
+
+				_inTable = false;
+				_table.clear();
+			}
+
+			/// <summary>
+			/// Returns the number of rows handed out
+			/// </summary>
+			size_t rowCount() const
+			{
+				return _rowCount;
+			}
+
+		private:
+			/// <summary>
+			/// Parses the current line
+			/// </summary>
+			void parseLine()
+			{
+				if (!_line.empty() && _line.back() == '\r') _line.pop_back();
+
+				size_t start = _line.find_first_not_of(" \t");
+				if (start == std::string::npos) return;
+
+				// Progress
+				if (!_format.progressPrefix.empty() && _line.compare(start, _format.progressPrefix.length(), _format.progressPrefix) == 0)
+				{
+					double progress;
+					if (parseProgress(start + _format.progressPrefix.length(), progress))
+					{
+						_pendingProgress = _line.substr(start);
+						_pendingValue = progress * _format.progressScale;
+
+						auto now = std::chrono::steady_clock::now();
+						if (!_reported || now - _lastReport >= _format.progressInterval) reportProgress();
+					}
+					return;
+				}
+
+				// Row of the current table, the first line that is not a row ends the table
+				if (_inTable || _format.tablePrefix.empty())
+				{
+					if (parseRow(start))
+					{
+						_rowCount++;
+						_onRow(_table, _columns);
+						return;
+					}
+					_inTable = false;
+				}
+
+				// Table header
+				if (!_format.tablePrefix.empty() && _line.compare(start, _format.tablePrefix.length(), _format.tablePrefix) == 0)
+				{
+					_inTable = true;
+					_table = _line.substr(start);
+				}
+			}
+
+			/// <summary>
+			/// Reads the first number after the position, returns false if there is none
+			/// </summary>
+			bool parseProgress(size_t position, double& progress) const
+			{
+				position = _line.find_first_of("0123456789.-+", position);
+				while (position != std::string::npos)
+				{
+					char* end;
+					progress = std::strtod(_line.c_str() + position, &end);
+					if (end != _line.c_str() + position) return true;
+
+					position = _line.find_first_of("0123456789.-+", position + 1);
+				}
+
+				return false;
+			}
+
+			/// <summary>
+			/// Splits the current line into numeric columns, returns false if a column is not numeric
+			/// </summary>
+			bool parseRow(size_t position)
+			{
+				_columns.clear();
+
+				while (true)
+				{
+					position = _line.find_first_not_of(_format.separators, position);
+					if (position == std::string::npos) break;
+
+					size_t columnEnd = _line.find_first_of(_format.separators, position);
+					if (columnEnd == std::string::npos) columnEnd = _line.length();
+
+					char* end;
+					double value = std::strtod(_line.c_str() + position, &end);
+					if (end != _line.c_str() + columnEnd) return false;
+
+					_columns.push_back(value);
+					position = columnEnd;
+				}
+
+				return !_columns.empty();
+			}
+
+			/// <summary>
+			/// Reports the pending progress
+			/// </summary>
+			void reportProgress()
+			{
+				_onProgress(_pendingProgress, _pendingValue);
+				_pendingProgress.clear();
+				_lastReport = std::chrono::steady_clock::now();
+				_reported = true;
+			}
+		};
+
+		/// <summary>
+		/// Converts table rows into data models and hands them to a consumer (e.g. a BinaryModelWriter or
+		/// a batched database insert). A single model is reused for all rows.
+		/// </summary>
+		/// <param name="T">Data model</param>
+		template<typename T>
+		class IpcRowEmitter
+		{
+		public:
+			/// <summary>
+			/// Stores a column in the model
+			/// </summary>
+			typedef std::function<void(T&, double)> ColumnSetter;
+
+		private:
+			/// <summary>
+			/// Current row, holds the attributes shared by all rows
+			/// </summary>
+			T _row;
+
+			/// <summary>
+			/// Setter per column, empty setters skip their column
+			/// </summary>
+			std::vector<ColumnSetter> _columns;
+
+			/// <summary>
+			/// Consumer
+			/// </summary>
+			std::function<void(const T&)> _consumer;
+
+			/// <summary>
+			/// Only tables whose header starts with this prefix are converted, empty converts all
+			/// </summary>
+			std::string _table;
+
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			/// <param name="prototype">Model with the attributes shared by all rows (e.g. the case id)</param>
+			/// <param name="columns">Setter per column</param>
+			/// <param name="consumer">Receives each model, the model is only valid during the call</param>
+			/// <param name="table">Header prefix of the converted tables, empty converts all</param>
+			IpcRowEmitter(T prototype, std::vector<ColumnSetter> columns, std::function<void(const T&)> consumer, std::string table = "") : _row(std::move(prototype)), _columns(std::move(columns)), _consumer(std::move(consumer)), _table(std::move(table))
+			{
+				// Empty
+			}
+
+			/// <summary>
+			/// Converts a row, rows with fewer columns than setters are skipped
+			/// </summary>
+			void operator()(const std::string& table, const std::vector<double>& columns)
+			{
+				if (!_table.empty() && table.compare(0, _table.length(), _table) != 0) return;
+				if (columns.size() < _columns.size()) return;
+
+				for (size_t i = 0; i < _columns.size(); i++)
+				{
+					if (_columns[i]) _columns[i](_row, columns[i]);
+				}
+
+				_consumer(_row);
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -1,21 +1,36 @@
 #pragma once
 
 #include <string>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <functional>
 #include "../Core/Interfaces/Ipc.h"
+#include "IpcReceiveBuffer.h"
 #include "../Logging/CarouselLogger.h"
 
 #ifdef _WIN32
 #include <Windows.h>
+#include <thread>
 #elif __unix__
-// TODO: Implement unix IPC
+#include <sys/types.h>
 #endif
 
 namespace carousel
 {
 	namespace ipcTools
 	{
-		constexpr int BUFFER_SIZE = 1024;
+		constexpr int BUFFER_SIZE = 64 * 1024;
 		constexpr int TIMEOUT = 30;
+		constexpr int IDLE_TIME = 100;
+		constexpr size_t PIPELINE_WINDOW = 32;
+
+		class IpcDispatcher;
+		class IpcCancellation;
 
 #ifdef _WIN32
 		typedef HANDLE SystemHandle;
@@ -23,6 +38,30 @@ namespace carousel
 		typedef int SystemHandle;
 #endif // OS
 
+		/// <summary>
+		/// Result of a pipelined batch of commands
+		/// </summary>
+		struct IpcBatchResult
+		{
+			/// <summary>
+			/// Responses of the completed commands, in command order
+			/// </summary>
+			std::vector<std::string> responses;
+
+			/// <summary>
+			/// Reason the batch stopped, empty if all commands completed
+			/// </summary>
+			std::string error;
+
+			/// <summary>
+			/// Returns true if all commands completed
+			/// </summary>
+			bool succeeded() const
+			{
+				return error.empty();
+			}
+		};
+
 		/// <summary>
 		/// IPC communication using pipes for applications that use stdout (e.g. console applications)
 		/// </summary>
@@ -50,19 +89,62 @@ namespace carousel
 			int _timeout;
 
 			/// <summary>
-			/// Allocated time for the process to initialize before starting communication.
+			/// Time in milliseconds the process has to stay silent after its initialization output,
+			/// used if the initialization output does not end with the end flag.
 			/// </summary>
 			int _initProcTime{ 500 };
 
+			/// <summary>
+			/// Time in milliseconds a read waits for data if no command is awaiting its response
+			/// </summary>
+			int _idleTime{ IDLE_TIME };
+
 			/// <summary>
 			/// If true, means the process is ready for communication
 			/// </summary>
-			bool _processReady{ false };
+			std::atomic<bool> _processReady{ false };
+
+			/// <summary>
+			/// If true, the process initialization has finished (successfully or not)
+			/// </summary>
+			bool _processStarted{ false };
+
+			/// <summary>
+			/// Guards the process state
+			/// </summary>
+			std::mutex _stateMutex;
+
+			/// <summary>
+			/// Signalled when the process initialization has finished
+			/// </summary>
+			std::condition_variable _stateChanged;
+
+			/// <summary>
+			/// Number of commands sent whose response has not been read yet
+			/// </summary>
+			int _pendingResponses{ 0 };
+
+			/// <summary>
+			/// True once the process has closed its output (e.g. it exited)
+			/// </summary>
+			bool _outputClosed{ false };
+
+			/// <summary>
+			/// Dispatcher that runs the asynchronous commands of this process, if any
+			/// </summary>
+			std::atomic<IpcDispatcher*> _dispatcher{ nullptr };
+
+			friend class IpcDispatcher;
+
+			/// <summary>
+			/// Received data, split into messages by the end flag
+			/// </summary>
+			IpcReceiveBuffer _receiveBuffer{ _endFlag };
 
 			/// <summary>
 			/// Process Id
 			/// </summary>
-			int _processId{ 0 };
+			std::atomic<int> _processId{ 0 };
 
 			/// <summary>
 			/// Pointer to process handle
@@ -89,6 +171,78 @@ namespace carousel
 			/// </summary>
 			SystemHandle _pipeWriteOut;
 
+#ifdef _WIN32
+			/// <summary>
+			/// Thread that blocks on the out pipe and collects its data
+			/// </summary>
+			std::thread _readerThread;
+
+			/// <summary>
+			/// Event set while collected data is available or the pipe was closed
+			/// </summary>
+			HANDLE _dataEvent;
+
+			/// <summary>
+			/// Data collected by the reader thread
+			/// </summary>
+			std::string _pipeData;
+
+			/// <summary>
+			/// True once the out pipe was closed
+			/// </summary>
+			bool _pipeClosed{ false };
+
+			/// <summary>
+			/// Guards the collected data
+			/// </summary>
+			std::mutex _pipeMutex;
+
+			/// <summary>
+			/// Signalled when data was collected or the pipe was closed
+			/// </summary>
+			std::condition_variable _pipeChanged;
+
+			/// <summary>
+			/// Thread that writes the data of asynchronous commands, anonymous pipes can't be written without blocking
+			/// </summary>
+			std::thread _writerThread;
+
+			/// <summary>
+			/// Event set while the writer thread is idle
+			/// </summary>
+			HANDLE _writeEvent;
+
+			/// <summary>
+			/// Data the writer thread is writing, empty while it is idle
+			/// </summary>
+			std::string _writeData;
+
+			/// <summary>
+			/// Error of the last failed write, 0 if none failed
+			/// </summary>
+			DWORD _writeError{ 0 };
+
+			/// <summary>
+			/// True once the writer thread has to stop
+			/// </summary>
+			bool _writerStopping{ false };
+
+			/// <summary>
+			/// Guards the data of the writer thread
+			/// </summary>
+			std::mutex _writeMutex;
+
+			/// <summary>
+			/// Signalled when data was queued, written or the writer thread has to stop
+			/// </summary>
+			std::condition_variable _writeChanged;
+#elif __unix__
+			/// <summary>
+			/// Epoll instance that watches the out pipe read handle
+			/// </summary>
+			SystemHandle _epollHandle;
+#endif // OS
+
 		public: // IpcPipeHandler
 
 			/// <summary>
@@ -106,7 +260,7 @@ namespace carousel
 			/// <summary>
 			/// Returns true if communication channel is ready
 			/// </summary>
-			bool isReady() const;
+			bool isReady() const override;
 
 			/// <summary>
 			/// Send command to process
@@ -116,7 +270,51 @@ namespace carousel
 			/// <summary>
 			/// Reads incoming data
 			/// </summary>
-			std::string read();
+			std::string read() override;
+
+			/// <summary>
+			/// Reads the response of a command in pieces, as the data arrives. The end flag is part of the
+			/// last piece. Only the data that was not handed out yet is buffered, so memory does not grow
+			/// with the length of the response. The timeout counts from the last received data.
+			/// Returns false if the end flag did not arrive within the timeout.
+			/// </summary>
+			/// <param name="onData">Receives the pieces of the response in order</param>
+			bool readStream(const std::function<void(const std::string&)>& onData);
+
+			/// <summary>
+			/// Sends the commands back-to-back and returns their responses in order. At most window
+			/// commands, and no more unanswered bytes than fit into the pipe buffer, are in flight, so a
+			/// write never blocks while the process waits for its output to be read.
+			/// The batch stops at the first command that does not complete (process closed its output or
+			/// the response did not arrive within the timeout, or a command could not be written). Responses
+			/// of the completed commands are kept. The process is terminated, its state is unknown and late
+			/// responses of the commands in flight would be taken for the responses of later commands.
+			/// Responses of commands sent with send have to be read before.
+			/// </summary>
+			/// <param name="commands">Commands, each one produces one response ending with the end flag</param>
+			/// <param name="window">Maximum number of commands awaiting their response</param>
+			IpcBatchResult sendBatch(const std::vector<std::string>& commands, size_t window = PIPELINE_WINDOW);
+
+			/// <summary>
+			/// Sends a command through the shared IpcDispatcher. The future holds the response, or an
+			/// IpcCommunicationException if the timeout was reached, the command was cancelled or the
+			/// process failed. Do not call send or read while asynchronous commands are pending.
+			/// </summary>
+			/// <param name="command">Command</param>
+			/// <param name="timeout">Time the response may take, a process that misses it is terminated</param>
+			/// <param name="cancellation">Optional cancellation</param>
+			std::future<std::string> sendAsync(const std::string& command, std::chrono::milliseconds timeout = std::chrono::seconds(TIMEOUT), std::shared_ptr<IpcCancellation> cancellation = nullptr);
+
+			/// <summary>
+			/// Terminates the process, pending asynchronous commands fail
+			/// </summary>
+			void terminate();
+
+			/// <summary>
+			/// Returns true if no response is awaited and no output is left unread, in the receive buffer
+			/// or in the pipe. Only then the next command's response is the next message.
+			/// </summary>
+			bool isDrained();
 
 		private: // Process initialization
 
@@ -140,17 +338,86 @@ namespace carousel
 			/// </summary>
 			void waitUntilReady();
 
+			/// <summary>
+			/// Consumes the initialization output of the process, returns true if the process responded
+			/// </summary>
+			bool waitForInitialization();
+
+			/// <summary>
+			/// Marks the process initialization as finished and wakes up waiting threads
+			/// </summary>
+			void setProcessState(bool ready);
+
+		private: // Asynchronous commands
+
+			/// <summary>
+			/// Returns a handle that is signalled when data is available (epoll instance on linux,
+			/// event on windows)
+			/// </summary>
+			SystemHandle notificationHandle() const;
+
+			/// <summary>
+			/// Returns a handle that is signalled while the in pipe can take data (write end on linux,
+			/// event on windows). Watched by the dispatcher while a command is partially written.
+			/// </summary>
+			SystemHandle writeNotificationHandle() const;
+
+			/// <summary>
+			/// Writes as much of the command as the in pipe takes without blocking, starting at offset.
+			/// Returns the new offset, once the command is written completely its response is awaited.
+			/// Throws if the process can't be written to.
+			/// </summary>
+			size_t sendAvailable(const std::string& command, size_t offset);
+
+			/// <summary>
+			/// Reads the available data into the receive buffer without blocking, throws if the
+			/// process closed its output. Returns the number of bytes read.
+			/// </summary>
+			size_t receive();
+
+			/// <summary>
+			/// Removes the first complete message from the receive buffer, returns false if there is none
+			/// </summary>
+			bool popMessage(std::string& message);
+
+			/// <summary>
+			/// Removes the process from its dispatcher, pending asynchronous commands fail
+			/// </summary>
+			void detachDispatcher();
+
 		private: // Helpers
 
 			/// <summary>
-			/// Reads from pipe
+			/// Reads the available data from pipe into the receive buffer, returns the number of bytes read
 			/// </summary>
-			std::string readFromPipe(SystemHandle pipeReadOut);
+			size_t readFromPipe(SystemHandle pipeReadOut, IpcReceiveBuffer& buffer);
 
 			/// <summary>
 			/// Writes to pipe
 			/// </summary>
 			void writeToPipe(const std::string& command, SystemHandle pipeWriteIn);
+
+			/// <summary>
+			/// Writes the data the pipe takes without blocking, returns the number of bytes written
+			/// </summary>
+			size_t writeAvailable(const char* data, size_t length, SystemHandle pipeWriteIn);
+
+			/// <summary>
+			/// Waits until data is available in the out pipe, returns false on timeout or if the pipe was closed
+			/// </summary>
+			bool waitForData(int timeoutMs);
+
+#ifdef _WIN32
+			/// <summary>
+			/// Reader thread, collects the out pipe data until the pipe is closed
+			/// </summary>
+			void readerLoop();
+
+			/// <summary>
+			/// Writer thread, writes the data of asynchronous commands until the process is closed
+			/// </summary>
+			void writerLoop();
+#endif // OS
 		};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,324 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <iterator>
+#include "IpcPipeHandler.h"
+#include "IpcWarmPool.h"
+#include "../Exceptions/IpcCommunicationException.h"
+#include "../Logging/CarouselLogger.h"
+
+namespace carousel
+{
+	namespace ipcTools
+	{
+		/// <summary>
+		/// Pool of solver processes for running independent calculations (e.g. one case per script) in
+		/// parallel. Each worker thread owns one IpcPipeHandler, scripts are taken from a shared queue by
+		/// the next idle worker. Scripts submitted with a worker affinity only run on that worker, in
+		/// submission order. With a warm profile, processes are initialized once and reset between scripts
+		/// instead of being restarted.
+		/// Note: Each script has to be self-contained, also with an affinity. The reset script runs after
+		/// every script and a failed process is replaced by a new one, solver state left by a previous
+		/// script is not kept.
+		/// </summary>
+		class IpcProcessPool
+		{
+		public:
+			/// <summary>
+			/// Commands sent to the process in order, one response is read per command
+			/// </summary>
+			typedef std::vector<std::string> Script;
+
+			/// <summary>
+			/// Responses to the commands of a script
+			/// </summary>
+			typedef std::vector<std::string> Responses;
+
+			/// <summary>
+			/// Scripts with this affinity run on any worker
+			/// </summary>
+			static constexpr size_t ANY_WORKER = static_cast<size_t>(-1);
+
+		private:
+			/// <summary>
+			/// Queued script
+			/// </summary>
+			struct Job
+			{
+				Script script;
+				std::promise<Responses> result;
+			};
+
+			/// <summary>
+			/// Path to executable
+			/// </summary>
+			const std::string _pathToExe;
+
+			/// <summary>
+			/// Flag that determines the end of a response
+			/// </summary>
+			const std::string _endFlag;
+
+			/// <summary>
+			/// Parameters used for starting a process
+			/// </summary>
+			const std::string _parameters;
+
+			/// <summary>
+			/// Timeout for receiving data, in seconds
+			/// </summary>
+			const int _timeout;
+
+			/// <summary>
+			/// Initialization and reset commands of the processes
+			/// </summary>
+			const IpcWarmProfile _profile;
+
+			/// <summary>
+			/// Scripts that run on any worker
+			/// </summary>
+			std::deque<Job> _queue;
+
+			/// <summary>
+			/// Scripts that run on a specific worker, one queue per worker
+			/// </summary>
+			std::vector<std::deque<Job>> _workerQueues;
+
+			/// <summary>
+			/// Guards the queues
+			/// </summary>
+			std::mutex _queueMutex;
+
+			/// <summary>
+			/// Signalled when a script was queued or the pool is stopping
+			/// </summary>
+			std::condition_variable _queueChanged;
+
+			/// <summary>
+			/// True once the pool is stopping
+			/// </summary>
+			bool _stopping{ false };
+
+			/// <summary>
+			/// Worker threads
+			/// </summary>
+			std::vector<std::thread> _workers;
+
+		public:
+			/// <summary>
+			/// Constructor, starts one process per worker
+			/// </summary>
+			/// <param name="pathToExe">Path to executable</param>
+			/// <param name="endFlag">Flag that determines the end of a response</param>
+			/// <param name="parameters">Parameters used for starting a process</param>
+			/// <param name="workerCount">Number of processes, 0 uses one process per core</param>
+			/// <param name="timeout">Timeout for receiving data, in seconds</param>
+			/// <param name="profile">Initialization and reset commands of the processes</param>
+			IpcProcessPool(std::string pathToExe, std::string endFlag, std::string parameters = "", size_t workerCount = 0, int timeout = TIMEOUT, IpcWarmProfile profile = {})
+				: _pathToExe(std::move(pathToExe)), _endFlag(std::move(endFlag)), _parameters(std::move(parameters)), _timeout(timeout), _profile(std::move(profile))
+			{
+				if (workerCount == 0) workerCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+				_workerQueues.resize(workerCount);
+
+				// Processes are started by the workers, in parallel
+				for (size_t i = 0; i < workerCount; i++)
+				{
+					_workers.emplace_back(&IpcProcessPool::workerLoop, this, i);
+				}
+			}
+
+			/// <summary>
+			/// Destructor, scripts that are running are finished, queued scripts are cancelled
+			/// </summary>
+			~IpcProcessPool()
+			{
+				std::deque<Job> cancelled;
+				{
+					std::lock_guard<std::mutex> lock(_queueMutex);
+					_stopping = true;
+
+					cancelled.swap(_queue);
+					for (auto& workerQueue : _workerQueues)
+					{
+						std::move(workerQueue.begin(), workerQueue.end(), std::back_inserter(cancelled));
+						workerQueue.clear();
+					}
+				}
+				_queueChanged.notify_all();
+
+				for (auto& job : cancelled)
+				{
+					job.result.set_exception(std::make_exception_ptr(carousel::exceptions::IpcCommunicationException("IpcProcessPool - Pool was stopped before the script was run.")));
+				}
+
+				for (auto& worker : _workers)
+				{
+					worker.join();
+				}
+			}
+
+			IpcProcessPool(const IpcProcessPool&) = delete;
+			IpcProcessPool& operator=(const IpcProcessPool&) = delete;
+
+		public:
+			/// <summary>
+			/// Queues a script. The future holds one response per command, or the
+			/// IpcCommunicationException if the process failed while running the script.
+			/// </summary>
+			/// <param name="script">Commands sent in order</param>
+			/// <param name="worker">Worker that has to run the script, ANY_WORKER for the next idle one</param>
+			std::future<Responses> submit(Script script, size_t worker = ANY_WORKER)
+			{
+				Job job;
+				job.script = std::move(script);
+				std::future<Responses> result = job.result.get_future();
+
+				{
+					std::lock_guard<std::mutex> lock(_queueMutex);
+					if (worker == ANY_WORKER)
+					{
+						_queue.push_back(std::move(job));
+					}
+					else
+					{
+						_workerQueues.at(worker).push_back(std::move(job));
+					}
+				}
+
+				// Workers with an affinity queue have to check as well
+				if (worker == ANY_WORKER)
+				{
+					_queueChanged.notify_one();
+				}
+				else
+				{
+					_queueChanged.notify_all();
+				}
+
+				return result;
+			}
+
+			/// <summary>
+			/// Runs all scripts and returns the responses in the order of the scripts
+			/// </summary>
+			std::vector<Responses> run(std::vector<Script> scripts)
+			{
+				std::vector<std::future<Responses>> futures;
+				for (auto& script : scripts)
+				{
+					futures.push_back(submit(std::move(script)));
+				}
+
+				std::vector<Responses> results;
+				for (auto& future : futures)
+				{
+					results.push_back(future.get());
+				}
+
+				return results;
+			}
+
+			/// <summary>
+			/// Returns the number of workers
+			/// </summary>
+			size_t workerCount() const
+			{
+				return _workers.size();
+			}
+
+			/// <summary>
+			/// Returns the number of scripts waiting for a worker
+			/// </summary>
+			size_t queuedCount()
+			{
+				std::lock_guard<std::mutex> lock(_queueMutex);
+				size_t count = _queue.size();
+				for (auto& workerQueue : _workerQueues)
+				{
+					count += workerQueue.size();
+				}
+
+				return count;
+			}
+
+		private:
+			/// <summary>
+			/// Worker, runs scripts until the pool is stopped. A process that failed is restarted
+			/// before the next script.
+			/// </summary>
+			void workerLoop(size_t index)
+			{
+				std::unique_ptr<IpcPipeHandler> handler;
+				try
+				{
+					handler = startProcess();
+				}
+				catch (const std::exception& e)
+				{
+					// Started again with the first script
+					carousel::logging::CarouselLogger::instance().warning("IpcProcessPool - Worker " + std::to_string(index) + " could not start its process: " + e.what());
+				}
+
+				while (true)
+				{
+					Job job;
+					{
+						std::unique_lock<std::mutex> lock(_queueMutex);
+						_queueChanged.wait(lock, [this, index]() { return _stopping || !_workerQueues[index].empty() || !_queue.empty(); });
+						if (_stopping) break;
+
+						// Scripts bound to this worker go first
+						std::deque<Job>& source = _workerQueues[index].empty() ? _queue : _workerQueues[index];
+						job = std::move(source.front());
+						source.pop_front();
+					}
+
+					try
+					{
+						if (!handler || !handler->isReady()) handler = startProcess();
+
+						job.result.set_value(runScript(*handler, job.script));
+					}
+					catch (...)
+					{
+						carousel::logging::CarouselLogger::instance().warning("IpcProcessPool - Worker " + std::to_string(index) + " failed, the process is restarted.");
+						job.result.set_exception(std::current_exception());
+						handler.reset();
+					}
+
+					// Warm processes are reset for the next script
+					if (handler && !_profile.reset.empty())
+					{
+						try
+						{
+							runScript(*handler, _profile.reset);
+						}
+						catch (const std::exception& e)
+						{
+							carousel::logging::CarouselLogger::instance().warning("IpcProcessPool - Worker " + std::to_string(index) + " could not reset its process: " + e.what());
+							handler.reset();
+						}
+					}
+				}
+			}
+
+			/// <summary>
+			/// Starts a process and runs the initialization of the warm profile
+			/// </summary>
+			std::unique_ptr<IpcPipeHandler> startProcess() const
+			{
+				std::unique_ptr<IpcPipeHandler> handler = std::make_unique<IpcPipeHandler>(_pathToExe, _endFlag, _parameters, _timeout);
+				runScript(*handler, _profile.initialization);
+				return handler;
+			}
+		};
+	}
+}
\ No newline at end of file
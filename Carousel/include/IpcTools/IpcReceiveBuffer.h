@@ -0,0 +1,353 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <cstring>
+
+namespace carousel
+{
+	namespace ipcTools
+	{
+		/// <summary>
+		/// Incremental delimiter search (Knuth-Morris-Pratt). The match state is carried between calls,
+		/// so a delimiter split across chunk boundaries is found without rescanning previous data.
+		/// </summary>
+		class DelimiterMatcher
+		{
+		public:
+			/// <summary>
+			/// Returned if the delimiter was not found
+			/// </summary>
+			static constexpr size_t npos = static_cast<size_t>(-1);
+
+		private:
+			/// <summary>
+			/// Delimiter
+			/// </summary>
+			std::string _delimiter;
+
+			/// <summary>
+			/// Length of the longest proper prefix that is also a suffix, for each delimiter prefix
+			/// </summary>
+			std::vector<size_t> _failure;
+
+			/// <summary>
+			/// Number of delimiter characters matched so far
+			/// </summary>
+			size_t _state{ 0 };
+
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			explicit DelimiterMatcher(std::string delimiter) : _delimiter(std::move(delimiter)), _failure(_delimiter.length(), 0)
+			{
+				for (size_t i = 1, k = 0; i < _delimiter.length(); i++)
+				{
+					while (k > 0 && _delimiter[i] != _delimiter[k]) k = _failure[k - 1];
+					if (_delimiter[i] == _delimiter[k]) k++;
+					_failure[i] = k;
+				}
+			}
+
+			/// <summary>
+			/// Feeds data to the matcher. Returns the number of bytes consumed up to and including the end
+			/// of the first match, or npos if the data contains no match. The state is reset after a match.
+			/// </summary>
+			size_t find(const char* data, size_t length)
+			{
+				if (_delimiter.empty()) return npos;
+
+				for (size_t i = 0; i < length; i++)
+				{
+					while (_state > 0 && data[i] != _delimiter[_state]) _state = _failure[_state - 1];
+					if (data[i] == _delimiter[_state]) _state++;
+
+					if (_state == _delimiter.length())
+					{
+						_state = 0;
+						return i + 1;
+					}
+				}
+
+				return npos;
+			}
+
+			/// <summary>
+			/// Forgets a partially matched delimiter
+			/// </summary>
+			void reset()
+			{
+				_state = 0;
+			}
+
+			/// <summary>
+			/// Returns the number of delimiter characters matched so far
+			/// </summary>
+			size_t matched() const
+			{
+				return _state;
+			}
+
+			/// <summary>
+			/// Returns the delimiter
+			/// </summary>
+			const std::string& delimiter() const
+			{
+				return _delimiter;
+			}
+		};
+
+		/// <summary>
+		/// Receive buffer for process output. Data is read straight into a ring buffer, new data is
+		/// scanned once for the end flag and complete messages (up to and including the end flag) are
+		/// handed out in order. Data that follows a message stays in the buffer for the next one.
+		/// The buffer only grows if a single message exceeds its capacity.
+		/// </summary>
+		class IpcReceiveBuffer
+		{
+		public:
+			/// <summary>
+			/// Initial capacity in bytes
+			/// </summary>
+			static constexpr size_t DEFAULT_CAPACITY = 64 * 1024;
+
+		private:
+			/// <summary>
+			/// Storage, the capacity is a power of two
+			/// </summary>
+			std::vector<char> _data;
+
+			/// <summary>
+			/// Absolute position of the first unread byte
+			/// </summary>
+			size_t _head{ 0 };
+
+			/// <summary>
+			/// Absolute position after the last written byte
+			/// </summary>
+			size_t _tail{ 0 };
+
+			/// <summary>
+			/// Absolute end positions of the complete messages, in order
+			/// </summary>
+			std::deque<size_t> _messageEnds;
+
+			/// <summary>
+			/// End flag matcher, only sees each byte once
+			/// </summary>
+			DelimiterMatcher _matcher;
+
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			/// <param name="endFlag">Flag that determines the end of a message</param>
+			/// <param name="capacity">Initial capacity, rounded up to a power of two</param>
+			explicit IpcReceiveBuffer(std::string endFlag, size_t capacity = DEFAULT_CAPACITY) : _matcher(std::move(endFlag))
+			{
+				size_t size = 1;
+				while (size < capacity) size <<= 1;
+				_data.resize(size);
+			}
+
+		public:
+			/// <summary>
+			/// Returns the number of buffered bytes
+			/// </summary>
+			size_t size() const
+			{
+				return _tail - _head;
+			}
+
+			/// <summary>
+			/// Returns the capacity in bytes
+			/// </summary>
+			size_t capacity() const
+			{
+				return _data.size();
+			}
+
+			/// <summary>
+			/// Returns true if a complete message is buffered
+			/// </summary>
+			bool hasMessage() const
+			{
+				return !_messageEnds.empty();
+			}
+
+			/// <summary>
+			/// Returns the number of complete messages buffered
+			/// </summary>
+			size_t messageCount() const
+			{
+				return _messageEnds.size();
+			}
+
+			/// <summary>
+			/// Returns contiguous free space for reading data into, the buffer grows if it is full.
+			/// Call commit with the number of bytes written.
+			/// </summary>
+			char* prepare(size_t& length)
+			{
+				if (size() == _data.size()) grow();
+
+				size_t start = _tail & mask();
+				length = std::min(_data.size() - size(), _data.size() - start);
+				return _data.data() + start;
+			}
+
+			/// <summary>
+			/// Adds bytes written into the prepared space and scans them for the end flag
+			/// </summary>
+			void commit(size_t length)
+			{
+				const char* data = _data.data() + (_tail & mask());
+				size_t position = 0;
+
+				while (position < length)
+				{
+					size_t consumed = _matcher.find(data + position, length - position);
+					if (consumed == DelimiterMatcher::npos) break;
+
+					position += consumed;
+					_messageEnds.push_back(_tail + position);
+				}
+
+				_tail += length;
+			}
+
+			/// <summary>
+			/// Copies data into the buffer
+			/// </summary>
+			void write(const char* data, size_t length)
+			{
+				while (length > 0)
+				{
+					size_t available;
+					char* region = prepare(available);
+					size_t count = std::min(available, length);
+
+					std::memcpy(region, data, count);
+					commit(count);
+
+					data += count;
+					length -= count;
+				}
+			}
+
+			/// <summary>
+			/// Removes and returns the first complete message, including the end flag.
+			/// Returns an empty string if no message is complete.
+			/// </summary>
+			std::string popMessage()
+			{
+				if (_messageEnds.empty()) return "";
+
+				size_t end = _messageEnds.front();
+				_messageEnds.pop_front();
+				return take(end);
+			}
+
+			/// <summary>
+			/// Removes and returns the received part of an incomplete message, except for the last bytes
+			/// that may be the beginning of the end flag. Returns an empty string if a message is complete.
+			/// </summary>
+			std::string popPartial()
+			{
+				if (!_messageEnds.empty()) return "";
+
+				return take(_tail - _matcher.matched());
+			}
+
+			/// <summary>
+			/// Removes and returns all buffered data, complete or not
+			/// </summary>
+			std::string popAll()
+			{
+				_messageEnds.clear();
+				_matcher.reset();
+				return take(_tail);
+			}
+
+			/// <summary>
+			/// Discards all buffered data
+			/// </summary>
+			void clear()
+			{
+				_messageEnds.clear();
+				_matcher.reset();
+				_head = _tail = 0;
+			}
+
+		private:
+			/// <summary>
+			/// Returns the index mask
+			/// </summary>
+			size_t mask() const
+			{
+				return _data.size() - 1;
+			}
+
+			/// <summary>
+			/// Removes and returns the data up to the absolute position
+			/// </summary>
+			std::string take(size_t end)
+			{
+				std::string result(end - _head, '\0');
+				copyOut(_data, _head, end, &result[0]);
+				_head = end;
+
+				// Empty buffer starts over at the beginning of the storage
+				if (_head == _tail && _messageEnds.empty())
+				{
+					_head = _tail = 0;
+				}
+
+				return result;
+			}
+
+			/// <summary>
+			/// Doubles the capacity, absolute positions stay valid
+			/// </summary>
+			void grow()
+			{
+				std::vector<char> data(_data.size() * 2);
+				size_t newMask = data.size() - 1;
+
+				// Copy contiguous runs, both the old and the new storage may wrap
+				for (size_t position = _head; position < _tail;)
+				{
+					size_t from = position & mask();
+					size_t to = position & newMask;
+					size_t count = std::min({ _tail - position, _data.size() - from, data.size() - to });
+
+					std::memcpy(data.data() + to, _data.data() + from, count);
+					position += count;
+				}
+
+				_data.swap(data);
+			}
+
+			/// <summary>
+			/// Copies the data between two absolute positions into the target
+			/// </summary>
+			static void copyOut(const std::vector<char>& data, size_t begin, size_t end, char* target)
+			{
+				size_t dataMask = data.size() - 1;
+
+				while (begin < end)
+				{
+					size_t from = begin & dataMask;
+					size_t count = std::min(end - begin, data.size() - from);
+
+					std::memcpy(target, data.data() + from, count);
+					target += count;
+					begin += count;
+				}
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include "IpcOutputParser.h"
+#include "../Data/SharedTypes/carouselModels.h"
+
+namespace carousel
+{
+	namespace ipcTools
+	{
+		/// <summary>
+		/// Phase fraction rows of an equilibrium case, columns: temperature, phase fraction
+		/// </summary>
+		/// <param name="idCase">Case of the rows</param>
+		/// <param name="consumer">Receives each row</param>
+		/// <param name="table">Header prefix of the converted tables, empty converts all</param>
+		inline IpcRowEmitter<carousel::data::EquilibriumPhaseFractionModel> equilibriumPhaseFractionRows(int idCase, std::function<void(const carousel::data::EquilibriumPhaseFractionModel&)> consumer, std::string table = "")
+		{
+			typedef carousel::data::EquilibriumPhaseFractionModel Row;
+
+			Row prototype;
+			prototype.IDCase(idCase);
+
+			return IpcRowEmitter<Row>(prototype,
+				{
+					[](Row& row, double value) { row.Temperature(value); },
+					[](Row& row, double value) { row.Value(value); }
+				},
+				std::move(consumer), std::move(table));
+		}
+
+		/// <summary>
+		/// Simulation data rows of a precipitation phase, columns: time, phase fraction, number density, mean radius
+		/// </summary>
+		/// <param name="idPrecipitationPhase">Precipitation phase of the rows</param>
+		/// <param name="idHeatTreatment">Heat treatment of the rows</param>
+		/// <param name="consumer">Receives each row</param>
+		/// <param name="table">Header prefix of the converted tables, empty converts all</param>
+		inline IpcRowEmitter<carousel::data::PrecipitationSimulationDataModel> precipitationSimulationDataRows(int idPrecipitationPhase, int idHeatTreatment, std::function<void(const carousel::data::PrecipitationSimulationDataModel&)> consumer, std::string table = "")
+		{
+			typedef carousel::data::PrecipitationSimulationDataModel Row;
+
+			Row prototype;
+			prototype.IDPrecipitationPhase(idPrecipitationPhase);
+			prototype.IDHeatTreatment(idHeatTreatment);
+
+			return IpcRowEmitter<Row>(prototype,
+				{
+					[](Row& row, double value) { row.Time(value); },
+					[](Row& row, double value) { row.PhaseFraction(value); },
+					[](Row& row, double value) { row.NumberDensity(value); },
+					[](Row& row, double value) { row.MeanRadius(value); }
+				},
+				std::move(consumer), std::move(table));
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include "../Core/Interfaces/Ipc.h"
+#include "IpcPipeHandler.h"
+
+namespace carousel
+{
+	namespace ipcTools
+	{
+		namespace sharedMemory
+		{
+			struct RingHeader;
+		}
+
+		/// <summary>
+		/// Transport for bulk results (e.g. numeric result tables) through a POSIX shared memory ring buffer.
+		/// The reader creates the shared memory, the solver wrapper connects with the C helper API
+		/// (IpcSharedMemoryApi.h) and writes records in binary form. Records are read in place, without
+		/// copies or text formatting. Control commands keep using the pipe (IpcPipeHandler).
+		/// Only available on linux.
+		/// </summary>
+		class IpcSharedMemory : public Ipc
+		{
+		public:
+			/// <summary>
+			/// Default ring capacity in bytes
+			/// </summary>
+			static constexpr size_t DEFAULT_CAPACITY = 4 * 1024 * 1024;
+
+		private:
+			/// <summary>
+			/// Name of the shared memory, passed to the writer
+			/// </summary>
+			std::string _name;
+
+			/// <summary>
+			/// Timeout for receiving a record, in seconds
+			/// </summary>
+			int _timeout;
+
+			/// <summary>
+			/// Mapping
+			/// </summary>
+			void* _mapping{ nullptr };
+
+			/// <summary>
+			/// Size of the mapping
+			/// </summary>
+			size_t _mappingSize{ 0 };
+
+			/// <summary>
+			/// Ring header in the mapping
+			/// </summary>
+			sharedMemory::RingHeader* _header{ nullptr };
+
+			/// <summary>
+			/// Ring data in the mapping
+			/// </summary>
+			const char* _data{ nullptr };
+
+		public:
+			/// <summary>
+			/// Constructor, creates the shared memory
+			/// </summary>
+			/// <param name="capacity">Ring capacity, rounded up to a power of two. Records can be up to half of it.</param>
+			/// <param name="timeout">Timeout for receiving a record, in seconds</param>
+			IpcSharedMemory(size_t capacity = DEFAULT_CAPACITY, int timeout = TIMEOUT);
+
+			/// <summary>
+			/// Destructor, removes the shared memory. A connected writer stops waiting for space.
+			/// </summary>
+			~IpcSharedMemory();
+
+			IpcSharedMemory(const IpcSharedMemory&) = delete;
+			IpcSharedMemory& operator=(const IpcSharedMemory&) = delete;
+
+		public: // IPC Interface
+
+			/// <summary>
+			/// Returns true while records can arrive or are buffered
+			/// </summary>
+			bool isReady() const override;
+
+			/// <summary>
+			/// Returns the next record, or an empty string if none arrived within the timeout or the writer closed
+			/// </summary>
+			std::string read() override;
+
+		public: // IpcSharedMemory
+
+			/// <summary>
+			/// Returns the name of the shared memory, the writer connects with it
+			/// </summary>
+			const std::string& name() const
+			{
+				return _name;
+			}
+
+			/// <summary>
+			/// Hands the next record to onRecord while it is still in the shared memory, the data is only
+			/// valid during the call. Returns false if no record arrived within the timeout or if the writer
+			/// closed and all records were read. Throws an IpcCommunicationException if a record in the
+			/// shared memory is corrupt.
+			/// </summary>
+			/// <param name="onRecord">Receives the record</param>
+			/// <param name="timeoutMs">Timeout in milliseconds, negative waits without limit</param>
+			bool readRecord(const std::function<void(const char* data, size_t length)>& onRecord, int timeoutMs);
+
+			/// <summary>
+			/// Returns true once the writer closed and all records were read
+			/// </summary>
+			bool isFinished() const;
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef CAROUSEL_IPC_SHARED_MEMORY_API_H
+#define CAROUSEL_IPC_SHARED_MEMORY_API_H
+
+/*
+ * Writer side of the IpcSharedMemory transport, for solver wrapper processes (C and C++).
+ * Link the CarouselShm library and librt (-lCarouselShm -lrt). Only the C runtime is used, C
+ * wrappers are linked with the C compiler and do not need the C++ runtime.
+ *
+ * The wrapper receives the name of the shared memory from Carousel (e.g. as a command over the
+ * pipe), writes its bulk results as records and keeps using stdout for control responses:
+ *
+ *     carousel_shm_writer* writer = carousel_shm_open_writer(name);
+ *     double* row = (double*)carousel_shm_reserve(writer, 4 * sizeof(double), 1000);
+ *     row[0] = time; row[1] = phaseFraction; row[2] = numberDensity; row[3] = meanRadius;
+ *     carousel_shm_commit(writer, 4 * sizeof(double));
+ *     carousel_shm_close_writer(writer);
+ *
+ * Functions that fail return NULL or -1 and set errno.
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Writer connected to a shared memory ring */
+typedef struct carousel_shm_writer carousel_shm_writer;
+
+/* Connects to the shared memory created by IpcSharedMemory, only one writer can be connected */
+carousel_shm_writer* carousel_shm_open_writer(const char* name);
+
+/* Returns the largest record that can be written, in bytes */
+size_t carousel_shm_max_record(const carousel_shm_writer* writer);
+
+/* Reserves space for a record and returns a pointer into the shared memory, the result is written
+   there directly. Waits up to timeoutMs (negative waits without limit) while the ring is full. */
+void* carousel_shm_reserve(carousel_shm_writer* writer, size_t length, int timeoutMs);
+
+/* Publishes the reserved record, length may be smaller than the reserved length */
+int carousel_shm_commit(carousel_shm_writer* writer, size_t length);
+
+/* Copies a record into the ring, same as reserve, memcpy and commit */
+int carousel_shm_write(carousel_shm_writer* writer, const void* data, size_t length, int timeoutMs);
+
+/* Disconnects, the reader receives the remaining records and then sees the end of the stream */
+void carousel_shm_close_writer(carousel_shm_writer* writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CAROUSEL_IPC_SHARED_MEMORY_API_H */
\ No newline at end of file
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <ctime>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+namespace carousel
+{
+	namespace ipcTools
+	{
+		/// <summary>
+		/// Layout of the shared memory ring buffer used by IpcSharedMemory (reader) and the C helper API in
+		/// IpcSharedMemoryApi.h (writer). Single writer, single reader. Records are variable sized, 8 byte
+		/// aligned and never wrap around the end of the ring, a padding record fills the rest instead.
+		/// Both sides block on futexes in the shared mapping.
+		/// </summary>
+		namespace sharedMemory
+		{
+			/// <summary>
+			/// Identifies the mapping ("CSHM")
+			/// </summary>
+			constexpr uint32_t MAGIC = 0x4D485343;
+
+			/// <summary>
+			/// Layout version
+			/// </summary>
+			constexpr uint32_t VERSION = 1;
+
+			/// <summary>
+			/// Offset of the ring data in the mapping
+			/// </summary>
+			constexpr size_t DATA_OFFSET = 256;
+
+			/// <summary>
+			/// Record types
+			/// </summary>
+			constexpr uint32_t RECORD_DATA = 0;
+			constexpr uint32_t RECORD_PADDING = 1;
+
+			/// <summary>
+			/// Writer states
+			/// </summary>
+			constexpr uint32_t WRITER_NONE = 0;
+			constexpr uint32_t WRITER_OPEN = 1;
+			constexpr uint32_t WRITER_CLOSED = 2;
+
+			static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free, "Futex words must be plain 32 bit integers");
+			static_assert(std::atomic<uint64_t>::is_always_lock_free, "Ring positions must be lock free across processes");
+
+			/// <summary>
+			/// Header at the start of the mapping. Positions are absolute byte counts, the ring index is
+			/// the position modulo the capacity. Reader and writer fields are on separate cache lines.
+			/// </summary>
+			struct RingHeader
+			{
+				uint32_t magic;
+				uint32_t version;
+				uint64_t capacity;
+
+				/// <summary>
+				/// Reader position, and the futex the writer waits on while the ring is full
+				/// </summary>
+				alignas(64) std::atomic<uint64_t> head;
+				std::atomic<uint32_t> spaceSequence;
+				std::atomic<uint32_t> writerWaiting;
+				std::atomic<uint32_t> readerClosed;
+
+				/// <summary>
+				/// Writer position, and the futex the reader waits on while the ring is empty
+				/// </summary>
+				alignas(64) std::atomic<uint64_t> tail;
+				std::atomic<uint32_t> dataSequence;
+				std::atomic<uint32_t> readerWaiting;
+				std::atomic<uint32_t> writerState;
+			};
+
+			static_assert(sizeof(RingHeader) <= DATA_OFFSET, "Ring header overlaps the data");
+
+			/// <summary>
+			/// Header of each record
+			/// </summary>
+			struct RecordHeader
+			{
+				uint32_t length;
+				uint32_t type;
+			};
+
+			/// <summary>
+			/// Returns the ring space used by a record with the given payload length
+			/// </summary>
+			inline size_t recordSize(size_t length)
+			{
+				return (sizeof(RecordHeader) + length + 7) & ~static_cast<size_t>(7);
+			}
+
+			/// <summary>
+			/// Waits while the futex word holds the expected value, returns false on timeout.
+			/// The futex is not private, it is shared between processes.
+			/// </summary>
+			inline bool futexWait(std::atomic<uint32_t>& word, uint32_t expected, int timeoutMs)
+			{
+				timespec timeout{ timeoutMs / 1000, (timeoutMs % 1000) * 1000000L };
+				long result = syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, timeoutMs < 0 ? nullptr : &timeout, nullptr, 0);
+				return result == 0 || errno != ETIMEDOUT;
+			}
+
+			/// <summary>
+			/// Wakes all threads waiting on the futex word
+			/// </summary>
+			inline void futexWake(std::atomic<uint32_t>& word)
+			{
+				syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+			}
+		}
+	}
+}
\ No newline at end of file
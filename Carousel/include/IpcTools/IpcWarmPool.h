@@ -0,0 +1,346 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include "IpcPipeHandler.h"
+#include "../Exceptions/IpcCommunicationException.h"
+#include "../Logging/CarouselLogger.h"
+
+namespace carousel
+{
+	namespace ipcTools
+	{
+		/// <summary>
+		/// Solver state that is expensive to set up (e.g. the thermodynamic, physical and mobility
+		/// databases of a project) and is shared by all jobs with the same profile name.
+		/// </summary>
+		struct IpcWarmProfile
+		{
+			/// <summary>
+			/// Profile name, processes are only reused for the same name (e.g. the database set)
+			/// </summary>
+			std::string name;
+
+			/// <summary>
+			/// Commands run once after the process started (e.g. loading databases)
+			/// </summary>
+			std::vector<std::string> initialization;
+
+			/// <summary>
+			/// Commands run after each job to restore the initialized state (e.g. removing
+			/// job specific phases and variables), instead of restarting the process
+			/// </summary>
+			std::vector<std::string> reset;
+		};
+
+		/// <summary>
+		/// Runs the commands of a script pipelined and returns the responses, throws if a command did not complete
+		/// </summary>
+		inline std::vector<std::string> runScript(IpcPipeHandler& handler, const std::vector<std::string>& script)
+		{
+			IpcBatchResult result = handler.sendBatch(script);
+			if (!result.succeeded())
+			{
+				throw carousel::exceptions::IpcCommunicationException(result.error);
+			}
+
+			return std::move(result.responses);
+		}
+
+		/// <summary>
+		/// Keeps initialized solver processes ready, per warm profile. Acquiring a process hands out an
+		/// idle one, only if none is available a new process is started and initialized. Released
+		/// processes are reset and kept for the next job.
+		/// </summary>
+		class IpcWarmPool
+		{
+		public:
+			/// <summary>
+			/// Process handed out by the pool, returned to the pool on destruction.
+			/// The pool has to outlive its leases.
+			/// </summary>
+			class Lease
+			{
+			private:
+				/// <summary>
+				/// Owning pool
+				/// </summary>
+				IpcWarmPool* _pool;
+
+				/// <summary>
+				/// Profile of the process
+				/// </summary>
+				const IpcWarmProfile* _profile;
+
+				/// <summary>
+				/// Process
+				/// </summary>
+				std::unique_ptr<IpcPipeHandler> _handler;
+
+				/// <summary>
+				/// If false, the process is closed instead of returned to the pool
+				/// </summary>
+				bool _reusable{ true };
+
+			public:
+				/// <summary>
+				/// Constructor
+				/// </summary>
+				Lease(IpcWarmPool* pool, const IpcWarmProfile* profile, std::unique_ptr<IpcPipeHandler> handler)
+					: _pool(pool), _profile(profile), _handler(std::move(handler))
+				{
+					// Empty
+				}
+
+				Lease(Lease&& other) noexcept
+					: _pool(other._pool), _profile(other._profile), _handler(std::move(other._handler)), _reusable(other._reusable)
+				{
+					other._pool = nullptr;
+				}
+
+				Lease(const Lease&) = delete;
+				Lease& operator=(const Lease&) = delete;
+				Lease& operator=(Lease&&) = delete;
+
+				/// <summary>
+				/// Destructor, returns the process to the pool
+				/// </summary>
+				~Lease()
+				{
+					if (_pool && _handler) _pool->release(*_profile, std::move(_handler), _reusable);
+				}
+
+				/// <summary>
+				/// Returns the process
+				/// </summary>
+				IpcPipeHandler& operator*() const
+				{
+					return *_handler;
+				}
+
+				/// <summary>
+				/// Returns the process
+				/// </summary>
+				IpcPipeHandler* operator->() const
+				{
+					return _handler.get();
+				}
+
+				/// <summary>
+				/// Marks the process as not reusable (e.g. the job left it in an unknown state)
+				/// </summary>
+				void discard()
+				{
+					_reusable = false;
+				}
+			};
+
+		private:
+			/// <summary>
+			/// Path to executable
+			/// </summary>
+			const std::string _pathToExe;
+
+			/// <summary>
+			/// Flag that determines the end of a response
+			/// </summary>
+			const std::string _endFlag;
+
+			/// <summary>
+			/// Parameters used for starting a process
+			/// </summary>
+			const std::string _parameters;
+
+			/// <summary>
+			/// Timeout for receiving data, in seconds
+			/// </summary>
+			const int _timeout;
+
+			/// <summary>
+			/// Maximum number of idle processes kept per profile
+			/// </summary>
+			size_t _maxIdle;
+
+			/// <summary>
+			/// Idle processes (profile name, processes)
+			/// </summary>
+			std::map<std::string, std::vector<std::unique_ptr<IpcPipeHandler>>> _idle;
+
+			/// <summary>
+			/// Guards the idle processes
+			/// </summary>
+			std::mutex _idleMutex;
+
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			/// <param name="pathToExe">Path to executable</param>
+			/// <param name="endFlag">Flag that determines the end of a response</param>
+			/// <param name="parameters">Parameters used for starting a process</param>
+			/// <param name="maxIdle">Maximum number of idle processes kept per profile</param>
+			/// <param name="timeout">Timeout for receiving data, in seconds</param>
+			IpcWarmPool(std::string pathToExe, std::string endFlag, std::string parameters = "", size_t maxIdle = 0, int timeout = TIMEOUT)
+				: _pathToExe(std::move(pathToExe)), _endFlag(std::move(endFlag)), _parameters(std::move(parameters)), _timeout(timeout), _maxIdle(maxIdle)
+			{
+				if (_maxIdle == 0) _maxIdle = std::max<size_t>(1, std::thread::hardware_concurrency());
+			}
+
+			IpcWarmPool(const IpcWarmPool&) = delete;
+			IpcWarmPool& operator=(const IpcWarmPool&) = delete;
+
+		public:
+			/// <summary>
+			/// Starts and initializes processes in parallel until the profile has the given number
+			/// of idle processes. Returns the number of processes that could be started.
+			/// </summary>
+			size_t prewarm(const IpcWarmProfile& profile, size_t count)
+			{
+				size_t missing = std::min(count, _maxIdle);
+				{
+					std::lock_guard<std::mutex> lock(_idleMutex);
+					size_t available = _idle[profile.name].size();
+					missing = missing > available ? missing - available : 0;
+				}
+
+				std::vector<std::unique_ptr<IpcPipeHandler>> started(missing);
+				std::vector<std::thread> starters;
+
+				// Joins started threads if starting another one throws, joinable threads must not be destroyed
+				struct StarterJoiner
+				{
+					std::vector<std::thread>& threads;
+					~StarterJoiner()
+					{
+						for (auto& thread : threads)
+						{
+							if (thread.joinable()) thread.join();
+						}
+					}
+				} joiner{ starters };
+
+				for (size_t i = 0; i < missing; i++)
+				{
+					starters.emplace_back([this, &profile, &started, i]()
+						{
+							try
+							{
+								started[i] = startProcess(profile);
+							}
+							catch (const std::exception& e)
+							{
+								carousel::logging::CarouselLogger::instance().warning("IpcWarmPool::prewarm - " + std::string(e.what()));
+							}
+						});
+				}
+
+				for (auto& starter : starters)
+				{
+					starter.join();
+				}
+
+				size_t startedCount{ 0 };
+				std::lock_guard<std::mutex> lock(_idleMutex);
+				for (auto& handler : started)
+				{
+					if (!handler) continue;
+					_idle[profile.name].push_back(std::move(handler));
+					startedCount++;
+				}
+
+				return startedCount;
+			}
+
+			/// <summary>
+			/// Hands out an initialized process for the profile. Starts a new process if no idle one
+			/// is available. The profile has to outlive the lease.
+			/// </summary>
+			Lease acquire(const IpcWarmProfile& profile)
+			{
+				{
+					std::lock_guard<std::mutex> lock(_idleMutex);
+					auto& idle = _idle[profile.name];
+
+					// Processes that exited while idle are dropped
+					while (!idle.empty())
+					{
+						std::unique_ptr<IpcPipeHandler> handler = std::move(idle.back());
+						idle.pop_back();
+						if (handler->isReady()) return Lease(this, &profile, std::move(handler));
+					}
+				}
+
+				// Cold start
+				return Lease(this, &profile, startProcess(profile));
+			}
+
+			/// <summary>
+			/// Returns the number of idle processes of the profile
+			/// </summary>
+			size_t idleCount(const std::string& profileName)
+			{
+				std::lock_guard<std::mutex> lock(_idleMutex);
+				auto idle = _idle.find(profileName);
+				return idle != _idle.end() ? idle->second.size() : 0;
+			}
+
+			/// <summary>
+			/// Closes all idle processes
+			/// </summary>
+			void clear()
+			{
+				std::lock_guard<std::mutex> lock(_idleMutex);
+				_idle.clear();
+			}
+
+		private:
+			/// <summary>
+			/// Starts a process and runs the initialization of the profile
+			/// </summary>
+			std::unique_ptr<IpcPipeHandler> startProcess(const IpcWarmProfile& profile) const
+			{
+				std::unique_ptr<IpcPipeHandler> handler = std::make_unique<IpcPipeHandler>(_pathToExe, _endFlag, _parameters, _timeout);
+				runScript(*handler, profile.initialization);
+				return handler;
+			}
+
+			/// <summary>
+			/// Resets a released process and keeps it, processes that can't be reset are closed.
+			/// Called from the lease destructor, nothing is thrown.
+			/// </summary>
+			void release(const IpcWarmProfile& profile, std::unique_ptr<IpcPipeHandler> handler, bool reusable) noexcept
+			{
+				try
+				{
+					if (!reusable || !handler->isReady()) return;
+
+					// Output the job left unread would be taken as the response of the reset script,
+					// and the responses of the next job would be shifted by one command
+					if (!handler->isDrained())
+					{
+						carousel::logging::CarouselLogger::instance().warning("IpcWarmPool - Released process has unread output and is closed.");
+						return;
+					}
+
+					runScript(*handler, profile.reset);
+
+					std::lock_guard<std::mutex> lock(_idleMutex);
+					auto& idle = _idle[profile.name];
+					if (idle.size() < _maxIdle) idle.push_back(std::move(handler));
+				}
+				catch (const std::exception& e)
+				{
+					carousel::logging::CarouselLogger::instance().warning("IpcWarmPool - Process could not be reset: " + std::string(e.what()));
+				}
+				catch (...)
+				{
+					carousel::logging::CarouselLogger::instance().warning("IpcWarmPool - Process could not be reset.");
+				}
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "../../../include/IpcTools/IpcEventWaiter.h"
+#include "../../../include/Exceptions/IpcCommunicationException.h"
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace carousel
+{
+	namespace ipcTools
+	{
+		namespace
+		{
+			/// <summary>
+			/// Id of the wake handle
+			/// </summary>
+			constexpr uint64_t WAKE_ID = static_cast<uint64_t>(-1);
+
+			/// <summary>
+			/// Maximum number of events returned per wait
+			/// </summary>
+			constexpr int MAX_EVENTS = 64;
+		}
+
+#pragma region Constructor&Destructor
+		IpcEventWaiter::IpcEventWaiter()
+		{
+			_epollHandle = epoll_create1(EPOLL_CLOEXEC);
+			_wakeHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+			if (_epollHandle < 0 || _wakeHandle < 0)
+			{
+				if (_epollHandle >= 0) ::close(_epollHandle);
+				if (_wakeHandle >= 0) ::close(_wakeHandle);
+				throw carousel::exceptions::IpcCommunicationException(std::string("IpcEventWaiter - ") + std::strerror(errno));
+			}
+
+			add(_wakeHandle, WAKE_ID);
+		}
+
+		IpcEventWaiter::~IpcEventWaiter()
+		{
+			::close(_wakeHandle);
+			::close(_epollHandle);
+		}
+#pragma endregion
+
+#pragma region Methods
+		void IpcEventWaiter::add(SystemHandle handle, uint64_t id)
+		{
+			epoll_event event;
+			memset(&event, 0, sizeof(event));
+			event.events = EPOLLIN;
+			event.data.u64 = id;
+
+			if (epoll_ctl(_epollHandle, EPOLL_CTL_ADD, handle, &event) != 0)
+			{
+				throw carousel::exceptions::IpcCommunicationException(std::string("IpcEventWaiter::add - ") + std::strerror(errno));
+			}
+		}
+
+		void IpcEventWaiter::addWritable(SystemHandle handle, uint64_t id)
+		{
+			epoll_event event;
+			memset(&event, 0, sizeof(event));
+			event.events = EPOLLOUT;
+			event.data.u64 = id;
+
+			if (epoll_ctl(_epollHandle, EPOLL_CTL_ADD, handle, &event) != 0)
+			{
+				throw carousel::exceptions::IpcCommunicationException(std::string("IpcEventWaiter::addWritable - ") + std::strerror(errno));
+			}
+		}
+
+		void IpcEventWaiter::remove(SystemHandle handle)
+		{
+			epoll_ctl(_epollHandle, EPOLL_CTL_DEL, handle, nullptr);
+		}
+
+		void IpcEventWaiter::wait(int timeoutMs, std::vector<uint64_t>& ready)
+		{
+			epoll_event events[MAX_EVENTS];
+			int count = epoll_wait(_epollHandle, events, MAX_EVENTS, timeoutMs < 0 ? -1 : timeoutMs);
+
+			for (int i = 0; i < count; i++)
+			{
+				if (events[i].data.u64 == WAKE_ID)
+				{
+					// Reset the wake counter
+					uint64_t value;
+					while (::read(_wakeHandle, &value, sizeof(value)) > 0);
+				}
+				else
+				{
+					ready.push_back(events[i].data.u64);
+				}
+			}
+		}
+
+		void IpcEventWaiter::wake()
+		{
+			uint64_t value = 1;
+			while (::write(_wakeHandle, &value, sizeof(value)) < 0 && errno == EINTR);
+		}
+#pragma endregion
+	}
+}
\ No newline at end of file
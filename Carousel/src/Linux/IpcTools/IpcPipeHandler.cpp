@@ -0,0 +1,470 @@
+#include "../../../include/IpcTools/IpcPipeHandler.h"
+#include "../../../include/Exceptions/IpcCommunicationException.h"
+#include "../../../include/Logging/CarouselLogger.h"
+#include <spawn.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/wait.h>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+extern char** environ;
+
+namespace carousel
+{
+	namespace ipcTools
+	{
+		namespace
+		{
+			/// <summary>
+			/// Splits a command line into arguments, double quotes group arguments that contain spaces
+			/// </summary>
+			std::vector<std::string> splitCommandLine(const std::string& commandLine)
+			{
+				std::vector<std::string> arguments;
+				std::string current;
+				bool quoted{ false };
+				bool hasArgument{ false };
+
+				for (char c : commandLine)
+				{
+					if (c == '"')
+					{
+						quoted = !quoted;
+						hasArgument = true;
+					}
+					else if (!quoted && (c == ' ' || c == '\t'))
+					{
+						if (hasArgument) arguments.push_back(current);
+						current.clear();
+						hasArgument = false;
+					}
+					else
+					{
+						current.push_back(c);
+						hasArgument = true;
+					}
+				}
+
+				if (hasArgument) arguments.push_back(current);
+				return arguments;
+			}
+
+			/// <summary>
+			/// Blocks SIGPIPE on the calling thread while writing to a process, a process that has exited
+			/// must not raise it in the caller. A pending signal is consumed before unblocking.
+			/// </summary>
+			class PipeSignalGuard
+			{
+			private:
+				/// <summary>
+				/// Set that only contains SIGPIPE
+				/// </summary>
+				sigset_t _pipeSignal;
+
+				/// <summary>
+				/// Signal mask of the thread before it was blocked
+				/// </summary>
+				sigset_t _previousSignals;
+
+			public:
+				/// <summary>
+				/// Set if a write failed with EPIPE, the signal is pending then
+				/// </summary>
+				bool brokenPipe{ false };
+
+				/// <summary>
+				/// Constructor, blocks SIGPIPE
+				/// </summary>
+				PipeSignalGuard()
+				{
+					sigemptyset(&_pipeSignal);
+					sigaddset(&_pipeSignal, SIGPIPE);
+					pthread_sigmask(SIG_BLOCK, &_pipeSignal, &_previousSignals);
+				}
+
+				/// <summary>
+				/// Destructor, restores the signal mask
+				/// </summary>
+				~PipeSignalGuard()
+				{
+					if (brokenPipe && !sigismember(&_previousSignals, SIGPIPE))
+					{
+						timespec noWait{ 0, 0 };
+						sigtimedwait(&_pipeSignal, nullptr, &noWait);
+					}
+					pthread_sigmask(SIG_SETMASK, &_previousSignals, nullptr);
+				}
+
+				PipeSignalGuard(const PipeSignalGuard&) = delete;
+				PipeSignalGuard& operator=(const PipeSignalGuard&) = delete;
+			};
+
+			/// <summary>
+			/// Closes a file descriptor if it is open and marks it as closed
+			/// </summary>
+			void closeHandle(SystemHandle& handle)
+			{
+				if (handle >= 0) ::close(handle);
+				handle = -1;
+			}
+		}
+
+#pragma region Constructor&Destructor
+		IpcPipeHandler::IpcPipeHandler(std::string pathToExe, std::string endFlag, std::string parameters, int timeout) :
+			_pathToExe(std::move(pathToExe)),
+			_endFlag(std::move(endFlag)),
+			_parameters(std::move(parameters)),
+			_timeout(timeout)
+		{
+			// Initialize default handles
+			_pipeWriteIn = -1;
+			_pipeReadOut = -1;
+			_pipeWriteOut = -1;
+			_pipeReadIn = -1;
+			_processHandle = -1;
+			_epollHandle = -1;
+
+			// Spawning a process is cheap on linux, initialization is done on the calling thread
+			startProcess();
+		}
+
+		IpcPipeHandler::~IpcPipeHandler()
+		{
+			detachDispatcher();
+			closeProcess();
+		}
+#pragma endregion
+
+#pragma region Methods
+		bool IpcPipeHandler::isReady() const
+		{
+			int processId = _processId;
+			if (!_processReady || processId <= 0) return false;
+
+			// Check the process state without reaping it, closeProcess collects the exit status
+			siginfo_t info;
+			memset(&info, 0, sizeof(info));
+			if (waitid(P_PID, static_cast<id_t>(processId), &info, WEXITED | WNOHANG | WNOWAIT) != 0)
+			{
+				carousel::logging::CarouselLogger::instance().warning("IpcPipeHandler::isReady could not query process '" + std::to_string(processId) + "': " + std::strerror(errno));
+				return false;
+			}
+
+			// si_pid is only set if the process has exited
+			return info.si_pid == 0;
+		}
+#pragma endregion
+
+#pragma region Private_helpers
+		void IpcPipeHandler::startProcess()
+		{
+			// Executable and arguments
+			std::vector<std::string> arguments = splitCommandLine(_pathToExe);
+			for (auto& parameter : splitCommandLine(_parameters))
+			{
+				arguments.push_back(std::move(parameter));
+			}
+
+			if (arguments.empty())
+			{
+				carousel::logging::CarouselLogger::instance().error("IpcPipeHandler::startProcess - No executable was specified.");
+				setProcessState(false);
+				return;
+			}
+
+			std::vector<char*> argv;
+			for (auto& argument : arguments)
+			{
+				argv.push_back(argument.data());
+			}
+			argv.push_back(nullptr);
+
+			createPipes();
+			if (_pipeReadOut < 0 || _epollHandle < 0)
+			{
+				closeProcess();
+				setProcessState(false);
+				return;
+			}
+
+			// Attach pipes to stdin, stdout and stderr of the child. The parent ends are
+			// close-on-exec, dup2 clears the flag on the standard descriptors.
+			posix_spawn_file_actions_t fileActions;
+			posix_spawn_file_actions_init(&fileActions);
+			posix_spawn_file_actions_adddup2(&fileActions, _pipeReadIn, STDIN_FILENO);
+			posix_spawn_file_actions_adddup2(&fileActions, _pipeWriteOut, STDOUT_FILENO);
+			posix_spawn_file_actions_adddup2(&fileActions, _pipeWriteOut, STDERR_FILENO);
+
+			// Child starts with default signal handlers
+			posix_spawnattr_t attributes;
+			posix_spawnattr_init(&attributes);
+			sigset_t defaultSignals;
+			sigemptyset(&defaultSignals);
+			sigaddset(&defaultSignals, SIGPIPE);
+			sigaddset(&defaultSignals, SIGCHLD);
+			posix_spawnattr_setsigdefault(&attributes, &defaultSignals);
+			posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGDEF);
+
+			// Try create new subprocess, PATH is searched if the executable has no path
+			pid_t processId = 0;
+			int spawnResult = posix_spawnp(&processId, argv[0], &fileActions, &attributes, argv.data(), environ);
+
+			posix_spawn_file_actions_destroy(&fileActions);
+			posix_spawnattr_destroy(&attributes);
+
+			// Child ends are owned by the child now, closing them lets the parent see end of file
+			closeHandle(_pipeReadIn);
+			closeHandle(_pipeWriteOut);
+
+			if (spawnResult != 0)
+			{
+				// Process did not initialize, clear handles
+				carousel::logging::CarouselLogger::instance().error("IpcPipeHandler::startProcess - Could not start '" + _pathToExe + "': " + std::strerror(spawnResult));
+				closeProcess();
+				setProcessState(false);
+				return;
+			}
+
+			_processId = static_cast<int>(processId);
+			_processHandle = _processId;
+
+			// Wait for process to finish initialization
+			bool isInitialized = waitForInitialization();
+			if (!isInitialized)
+			{
+				carousel::logging::CarouselLogger::instance().error("IpcPipeHandler::startProcess - Process '" + _pathToExe + "' did not respond within the expected time.");
+			}
+
+			setProcessState(isInitialized);
+		}
+
+		void IpcPipeHandler::closeProcess()
+		{
+			_processReady = false;
+
+			// Closing stdin first gives the process the chance to see end of file
+			closeHandle(_pipeWriteIn);
+			closeHandle(_pipeReadOut);
+			closeHandle(_pipeWriteOut);
+			closeHandle(_pipeReadIn);
+			closeHandle(_epollHandle);
+
+			// Force closing process and reap it, no zombie is left behind
+			if (_processId > 0)
+			{
+				pid_t processId = static_cast<pid_t>(_processId);
+				if (waitpid(processId, nullptr, WNOHANG) == 0)
+				{
+					kill(processId, SIGKILL);
+					while (waitpid(processId, nullptr, 0) < 0 && errno == EINTR);
+				}
+			}
+
+			_processId = 0;
+			_processHandle = -1;
+		}
+
+		void IpcPipeHandler::createPipes()
+		{
+			int pipeIn[2];
+			int pipeOut[2];
+
+			if (pipe2(pipeIn, O_CLOEXEC) != 0)
+			{
+				carousel::logging::CarouselLogger::instance().error(std::string("IpcPipeHandler::createPipes - ") + std::strerror(errno));
+				return;
+			}
+
+			if (pipe2(pipeOut, O_CLOEXEC) != 0)
+			{
+				carousel::logging::CarouselLogger::instance().error(std::string("IpcPipeHandler::createPipes - ") + std::strerror(errno));
+				::close(pipeIn[0]);
+				::close(pipeIn[1]);
+				return;
+			}
+
+			_pipeReadIn = pipeIn[0];
+			_pipeWriteIn = pipeIn[1];
+			_pipeReadOut = pipeOut[0];
+			_pipeWriteOut = pipeOut[1];
+
+			// Parent ends never block
+			fcntl(_pipeWriteIn, F_SETFL, fcntl(_pipeWriteIn, F_GETFL) | O_NONBLOCK);
+			fcntl(_pipeReadOut, F_SETFL, fcntl(_pipeReadOut, F_GETFL) | O_NONBLOCK);
+
+			// Reads are driven by epoll
+			_epollHandle = epoll_create1(EPOLL_CLOEXEC);
+			if (_epollHandle < 0)
+			{
+				carousel::logging::CarouselLogger::instance().error(std::string("IpcPipeHandler::createPipes - ") + std::strerror(errno));
+				return;
+			}
+
+			epoll_event event;
+			memset(&event, 0, sizeof(event));
+			event.events = EPOLLIN;
+			event.data.fd = _pipeReadOut;
+			if (epoll_ctl(_epollHandle, EPOLL_CTL_ADD, _pipeReadOut, &event) != 0)
+			{
+				carousel::logging::CarouselLogger::instance().error(std::string("IpcPipeHandler::createPipes - ") + std::strerror(errno));
+				closeHandle(_epollHandle);
+			}
+		}
+#pragma endregion
+
+#pragma region Helpers
+		size_t IpcPipeHandler::readFromPipe(SystemHandle pipeReadOut, IpcReceiveBuffer& buffer)
+		{
+			size_t totalRead = 0;
+
+			// Read straight into the receive buffer until the pipe is drained, the handle is non-blocking
+			while (true)
+			{
+				size_t length;
+				char* region = buffer.prepare(length);
+				ssize_t bytesRead = ::read(pipeReadOut, region, length);
+
+				if (bytesRead > 0)
+				{
+					buffer.commit(static_cast<size_t>(bytesRead));
+					totalRead += static_cast<size_t>(bytesRead);
+
+					// A short read means the pipe is empty
+					if (static_cast<size_t>(bytesRead) < length) break;
+				}
+				else if (bytesRead < 0 && errno == EINTR)
+				{
+					continue;
+				}
+				else
+				{
+					// End of file, EAGAIN or error
+					break;
+				}
+			}
+
+			return totalRead;
+		}
+
+		void IpcPipeHandler::writeToPipe(const std::string& command, SystemHandle pipeWriteIn)
+		{
+			size_t dataLen = command.length();
+			size_t totalWritten = 0;
+			std::string error;
+
+			{
+				PipeSignalGuard signalGuard;
+				while (totalWritten < dataLen)
+				{
+					ssize_t written = ::write(pipeWriteIn, command.c_str() + totalWritten, dataLen - totalWritten);
+
+					if (written >= 0)
+					{
+						totalWritten += static_cast<size_t>(written);
+					}
+					else if (errno == EAGAIN || errno == EWOULDBLOCK)
+					{
+						// Pipe is full, wait until the process reads
+						pollfd writable{ pipeWriteIn, POLLOUT, 0 };
+						if (poll(&writable, 1, _timeout * 1000) == 0)
+						{
+							error = "Process did not read its input within the expected time.";
+							break;
+						}
+					}
+					else if (errno != EINTR)
+					{
+						signalGuard.brokenPipe = errno == EPIPE;
+						error = std::strerror(errno);
+						break;
+					}
+				}
+			}
+
+			// A partially written command leaves the process in an unknown state
+			if (!error.empty())
+			{
+				throw carousel::exceptions::IpcCommunicationException("IpcPipeHandler::writeToPipe - " + error + " (" + std::to_string(totalWritten) + " of " + std::to_string(dataLen) + " bytes written)");
+			}
+		}
+
+		size_t IpcPipeHandler::writeAvailable(const char* data, size_t length, SystemHandle pipeWriteIn)
+		{
+			if (pipeWriteIn < 0)
+			{
+				throw carousel::exceptions::IpcCommunicationException("IpcPipeHandler::writeAvailable - Communication to process is broken.");
+			}
+
+			size_t totalWritten = 0;
+			std::string error;
+
+			{
+				PipeSignalGuard signalGuard;
+				while (totalWritten < length)
+				{
+					ssize_t written = ::write(pipeWriteIn, data + totalWritten, length - totalWritten);
+
+					if (written >= 0)
+					{
+						totalWritten += static_cast<size_t>(written);
+					}
+					else if (errno == EAGAIN || errno == EWOULDBLOCK)
+					{
+						// Pipe is full, the rest is written once the process reads
+						break;
+					}
+					else if (errno != EINTR)
+					{
+						signalGuard.brokenPipe = errno == EPIPE;
+						error = std::strerror(errno);
+						break;
+					}
+				}
+			}
+
+			if (!error.empty())
+			{
+				throw carousel::exceptions::IpcCommunicationException("IpcPipeHandler::writeAvailable - " + error);
+			}
+
+			return totalWritten;
+		}
+
+		SystemHandle IpcPipeHandler::notificationHandle() const
+		{
+			// Epoll instances can be watched by another epoll instance
+			return _epollHandle;
+		}
+
+		SystemHandle IpcPipeHandler::writeNotificationHandle() const
+		{
+			return _pipeWriteIn;
+		}
+
+		bool IpcPipeHandler::waitForData(int timeoutMs)
+		{
+			if (_epollHandle < 0) return false;
+
+			epoll_event event;
+			int count;
+			do
+			{
+				count = epoll_wait(_epollHandle, &event, 1, timeoutMs);
+			} while (count < 0 && errno == EINTR);
+
+			// A closed pipe without pending data is reported as EPOLLHUP only
+			if (count > 0 && (event.events & EPOLLIN) == 0 && (event.events & (EPOLLHUP | EPOLLERR)) != 0)
+			{
+				_outputClosed = true;
+			}
+
+			return count > 0 && (event.events & EPOLLIN) != 0;
+		}
+#pragma endregion
+	}
+}
\ No newline at end of file
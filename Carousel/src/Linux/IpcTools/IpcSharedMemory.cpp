@@ -0,0 +1,168 @@
+#include "../../../include/IpcTools/IpcSharedMemory.h"
+#include "../../../include/IpcTools/IpcSharedMemoryLayout.h"
+#include "../../../include/Exceptions/IpcCommunicationException.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+namespace carousel
+{
+	namespace ipcTools
+	{
+		using namespace sharedMemory;
+
+		namespace
+		{
+			/// <summary>
+			/// Makes shared memory names unique within the process
+			/// </summary>
+			std::atomic<unsigned int> nameCounter{ 0 };
+		}
+
+#pragma region Constructor&Destructor
+		IpcSharedMemory::IpcSharedMemory(size_t capacity, int timeout) : _timeout(timeout)
+		{
+			size_t ringSize = 4096;
+			while (ringSize < capacity) ringSize <<= 1;
+
+			_name = "/carousel-" + std::to_string(getpid()) + "-" + std::to_string(nameCounter++);
+			int handle = shm_open(_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+			if (handle < 0)
+			{
+				throw carousel::exceptions::IpcCommunicationException("IpcSharedMemory - Could not create " + _name + ": " + std::strerror(errno));
+			}
+
+			_mappingSize = DATA_OFFSET + ringSize;
+			if (ftruncate(handle, static_cast<off_t>(_mappingSize)) != 0)
+			{
+				std::string error = std::strerror(errno);
+				::close(handle);
+				shm_unlink(_name.c_str());
+				throw carousel::exceptions::IpcCommunicationException("IpcSharedMemory - Could not size " + _name + ": " + error);
+			}
+
+			_mapping = mmap(nullptr, _mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, handle, 0);
+			::close(handle);
+			if (_mapping == MAP_FAILED)
+			{
+				std::string error = std::strerror(errno);
+				_mapping = nullptr;
+				shm_unlink(_name.c_str());
+				throw carousel::exceptions::IpcCommunicationException("IpcSharedMemory - Could not map " + _name + ": " + error);
+			}
+
+			// The writer only learns the name after the header is initialized
+			_header = new (_mapping) RingHeader();
+			_header->magic = MAGIC;
+			_header->version = VERSION;
+			_header->capacity = ringSize;
+			_data = static_cast<const char*>(_mapping) + DATA_OFFSET;
+		}
+
+		IpcSharedMemory::~IpcSharedMemory()
+		{
+			// A writer that waits for space gives up
+			_header->readerClosed.store(1);
+			_header->spaceSequence.fetch_add(1);
+			futexWake(_header->spaceSequence);
+
+			// The writer keeps its own mapping until it disconnects
+			munmap(_mapping, _mappingSize);
+			shm_unlink(_name.c_str());
+		}
+#pragma endregion
+
+#pragma region Methods
+		bool IpcSharedMemory::isReady() const
+		{
+			return !isFinished();
+		}
+
+		std::string IpcSharedMemory::read()
+		{
+			std::string record;
+			readRecord([&record](const char* data, size_t length) { record.assign(data, length); }, _timeout * 1000);
+			return record;
+		}
+
+		bool IpcSharedMemory::readRecord(const std::function<void(const char* data, size_t length)>& onRecord, int timeoutMs)
+		{
+			uint64_t capacity = _header->capacity;
+			auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+			while (true)
+			{
+				uint32_t sequence = _header->dataSequence.load();
+				uint64_t head = _header->head.load(std::memory_order_relaxed);
+
+				uint64_t tail = _header->tail.load();
+				if (head != tail)
+				{
+					// The record header is written by the other process, it is copied once and checked
+					// before the record is used. Records never wrap around the end of the ring.
+					const char* position = _data + (head & (capacity - 1));
+					RecordHeader record;
+					std::memcpy(&record, position, sizeof(RecordHeader));
+
+					uint64_t size = recordSize(record.length);
+					uint64_t contiguous = capacity - (head & (capacity - 1));
+					if (tail - head > capacity || size > tail - head || size > contiguous || (record.type != RECORD_DATA && record.type != RECORD_PADDING))
+					{
+						throw carousel::exceptions::IpcCommunicationException("IpcSharedMemory::readRecord - Corrupt record in " + _name + " (length " +
+							std::to_string(record.length) + ", type " + std::to_string(record.type) + ", " + std::to_string(tail - head) + " bytes published)");
+					}
+
+					if (record.type == RECORD_DATA)
+					{
+						onRecord(position + sizeof(RecordHeader), record.length);
+					}
+
+					// Frees the space, a writer that waits for it is woken
+					_header->head.store(head + size);
+					_header->spaceSequence.fetch_add(1);
+					if (_header->writerWaiting.load()) futexWake(_header->spaceSequence);
+
+					if (record.type == RECORD_DATA) return true;
+					continue;
+				}
+
+				if (_header->writerState.load() == WRITER_CLOSED)
+				{
+					// Records published right before closing
+					if (head != _header->tail.load()) continue;
+					return false;
+				}
+
+				// Announced before the last check, the writer wakes the futex after publishing
+				_header->readerWaiting.store(1);
+				if (head != _header->tail.load() || _header->writerState.load() == WRITER_CLOSED)
+				{
+					_header->readerWaiting.store(0);
+					continue;
+				}
+
+				int waitTime = -1;
+				if (timeoutMs >= 0)
+				{
+					auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+					waitTime = remaining > 0 ? static_cast<int>(remaining) : 0;
+				}
+
+				bool woken = waitTime != 0 && futexWait(_header->dataSequence, sequence, waitTime);
+				_header->readerWaiting.store(0);
+
+				if (!woken) return false;
+			}
+		}
+
+		bool IpcSharedMemory::isFinished() const
+		{
+			return _header->writerState.load() == WRITER_CLOSED && _header->head.load() == _header->tail.load();
+		}
+#pragma endregion
+	}
+}
\ No newline at end of file
@@ -0,0 +1,243 @@
+#include "../../../include/IpcTools/IpcSharedMemoryApi.h"
+#include "../../../include/IpcTools/IpcSharedMemoryLayout.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+using namespace carousel::ipcTools::sharedMemory;
+
+/// <summary>
+/// Writer state, only used by the writing process
+/// </summary>
+struct carousel_shm_writer
+{
+	/// <summary>
+	/// Mapping
+	/// </summary>
+	void* mapping;
+
+	/// <summary>
+	/// Size of the mapping
+	/// </summary>
+	size_t mappingSize;
+
+	/// <summary>
+	/// Ring header in the mapping
+	/// </summary>
+	RingHeader* header;
+
+	/// <summary>
+	/// Ring data in the mapping
+	/// </summary>
+	char* data;
+
+	/// <summary>
+	/// Position of the reserved record, only published on commit
+	/// </summary>
+	uint64_t reserved;
+
+	/// <summary>
+	/// Payload length of the reserved record
+	/// </summary>
+	size_t reservedLength;
+
+	/// <summary>
+	/// True while a record is reserved
+	/// </summary>
+	bool hasReservation;
+};
+
+// Solver wrappers written in C link this library, only the C runtime is used (no new, delete or std::chrono)
+namespace
+{
+	/// <summary>
+	/// Returns the monotonic clock in milliseconds
+	/// </summary>
+	int64_t monotonicMs()
+	{
+		timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		return static_cast<int64_t>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+	}
+
+	/// <summary>
+	/// Waits until the ring has the requested free space, returns false on timeout or if the reader is gone
+	/// </summary>
+	bool waitForSpace(carousel_shm_writer* writer, uint64_t tail, size_t space, int timeoutMs)
+	{
+		RingHeader* header = writer->header;
+		int64_t deadline = monotonicMs() + timeoutMs;
+
+		while (true)
+		{
+			uint32_t sequence = header->spaceSequence.load();
+			if (header->capacity - (tail - header->head.load()) >= space) return true;
+
+			if (header->readerClosed.load())
+			{
+				errno = EPIPE;
+				return false;
+			}
+
+			// Announced before the last check, the reader wakes the futex after freeing space
+			header->writerWaiting.store(1);
+			if (header->capacity - (tail - header->head.load()) >= space)
+			{
+				header->writerWaiting.store(0);
+				return true;
+			}
+
+			int waitTime = -1;
+			if (timeoutMs >= 0)
+			{
+				int64_t remaining = deadline - monotonicMs();
+				waitTime = remaining > 0 ? static_cast<int>(remaining) : 0;
+			}
+
+			bool woken = waitTime != 0 && futexWait(header->spaceSequence, sequence, waitTime);
+			header->writerWaiting.store(0);
+
+			if (!woken)
+			{
+				errno = ETIMEDOUT;
+				return false;
+			}
+		}
+	}
+}
+
+carousel_shm_writer* carousel_shm_open_writer(const char* name)
+{
+	int handle = shm_open(name, O_RDWR, 0);
+	if (handle < 0) return nullptr;
+
+	struct stat status;
+	if (fstat(handle, &status) != 0 || static_cast<size_t>(status.st_size) <= DATA_OFFSET)
+	{
+		::close(handle);
+		errno = EINVAL;
+		return nullptr;
+	}
+
+	size_t mappingSize = static_cast<size_t>(status.st_size);
+	void* mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, handle, 0);
+	::close(handle);
+	if (mapping == MAP_FAILED) return nullptr;
+
+	RingHeader* header = static_cast<RingHeader*>(mapping);
+	uint32_t state = WRITER_NONE;
+	if (header->magic != MAGIC || header->version != VERSION || header->capacity + DATA_OFFSET > mappingSize)
+	{
+		munmap(mapping, mappingSize);
+		errno = EINVAL;
+		return nullptr;
+	}
+
+	// Single writer
+	if (!header->writerState.compare_exchange_strong(state, WRITER_OPEN))
+	{
+		munmap(mapping, mappingSize);
+		errno = EBUSY;
+		return nullptr;
+	}
+
+	carousel_shm_writer* writer = static_cast<carousel_shm_writer*>(std::malloc(sizeof(carousel_shm_writer)));
+	if (!writer)
+	{
+		header->writerState.store(WRITER_NONE);
+		munmap(mapping, mappingSize);
+		errno = ENOMEM;
+		return nullptr;
+	}
+
+	*writer = carousel_shm_writer{ mapping, mappingSize, header, static_cast<char*>(mapping) + DATA_OFFSET, 0, 0, false };
+	return writer;
+}
+
+size_t carousel_shm_max_record(const carousel_shm_writer* writer)
+{
+	// A record may need a padding record in front of it, half the ring always fits
+	return writer->header->capacity / 2 - sizeof(RecordHeader);
+}
+
+void* carousel_shm_reserve(carousel_shm_writer* writer, size_t length, int timeoutMs)
+{
+	if (length > carousel_shm_max_record(writer))
+	{
+		errno = EMSGSIZE;
+		return nullptr;
+	}
+
+	RingHeader* header = writer->header;
+	uint64_t capacity = header->capacity;
+	uint64_t tail = header->tail.load(std::memory_order_relaxed);
+	size_t size = recordSize(length);
+
+	// Records do not wrap, the rest of the ring is skipped with a padding record
+	uint64_t contiguous = capacity - (tail & (capacity - 1));
+	uint64_t padding = contiguous < size ? contiguous : 0;
+
+	if (!waitForSpace(writer, tail, padding + size, timeoutMs)) return nullptr;
+
+	if (padding > 0)
+	{
+		RecordHeader* record = reinterpret_cast<RecordHeader*>(writer->data + (tail & (capacity - 1)));
+		record->length = static_cast<uint32_t>(padding - sizeof(RecordHeader));
+		record->type = RECORD_PADDING;
+		tail += padding;
+	}
+
+	writer->reserved = tail;
+	writer->reservedLength = length;
+	writer->hasReservation = true;
+	return writer->data + (tail & (capacity - 1)) + sizeof(RecordHeader);
+}
+
+int carousel_shm_commit(carousel_shm_writer* writer, size_t length)
+{
+	if (!writer->hasReservation || length > writer->reservedLength)
+	{
+		errno = EINVAL;
+		return -1;
+	}
+
+	RingHeader* header = writer->header;
+	RecordHeader* record = reinterpret_cast<RecordHeader*>(writer->data + (writer->reserved & (header->capacity - 1)));
+	record->length = static_cast<uint32_t>(length);
+	record->type = RECORD_DATA;
+	writer->hasReservation = false;
+
+	// Publishes the record (and a padding record in front of it)
+	header->tail.store(writer->reserved + recordSize(length));
+	header->dataSequence.fetch_add(1);
+	if (header->readerWaiting.load()) futexWake(header->dataSequence);
+
+	return 0;
+}
+
+int carousel_shm_write(carousel_shm_writer* writer, const void* data, size_t length, int timeoutMs)
+{
+	void* target = carousel_shm_reserve(writer, length, timeoutMs);
+	if (!target) return -1;
+
+	std::memcpy(target, data, length);
+	return carousel_shm_commit(writer, length);
+}
+
+void carousel_shm_close_writer(carousel_shm_writer* writer)
+{
+	if (!writer) return;
+
+	RingHeader* header = writer->header;
+	header->writerState.store(WRITER_CLOSED);
+	header->dataSequence.fetch_add(1);
+	futexWake(header->dataSequence);
+
+	munmap(writer->mapping, writer->mappingSize);
+	std::free(writer);
+}
\ No newline at end of file
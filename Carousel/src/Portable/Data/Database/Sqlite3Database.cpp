@@ -1,5 +1,7 @@
 
 #include "../../../../include/Data/Database/Sqlite3Database.h"
+#include "../../../../include/Data/Models/EquilibriumSummary.h"
+#include "../../../../include/Data/Models/PrecipitationSummary.h"
 #include <sstream>
 
 namespace carousel
@@ -122,6 +124,9 @@ namespace carousel
 				case carousel::data::UNIQUE:
 					query += column->getName() + " " + MapToSqlType(column->getType()) + " NOT NULL UNIQUE ";
 					break;
+				case carousel::data::FOREIGN_KEY:
+					query += column->getName() + " " + MapToSqlType(column->getType()) + " REFERENCES '" + column->getReferencedTable() + "'(" + column->getReferencedColumn() + ") ";
+					break;
 				default:
 					throw carousel::exceptions::NotImplementedException("createTable: Constraint type is not defined.");
 					break;
@@ -181,67 +186,367 @@ namespace carousel
 
 		void Sqlite3Database::save(IDatabaseObject* object)
 		{
-			DatabaseTable table = object->get_table_structure();
-			carousel::logging::CarouselLogger::instance().Info("Saving IDatabaseObject: " + table.getTableName());
+			carousel::logging::CarouselLogger::instance().Info("Saving IDatabaseObject: " + object->get_table_structure().getTableName());
+			saveEntry(object);
+		}
 
-			// check if this is a new constraint
-			bool isNew = isNewEntry(&table, object);
+		void Sqlite3Database::save(std::vector<IDatabaseObject*> objects)
+		{
+			if (objects.empty()) return;
+			carousel::logging::CarouselLogger::instance().Info("Saving " + std::to_string(objects.size()) + " IDatabaseObjects");
 
-			// Build query
-			std::ostringstream queryStream;
-			if (isNew)
+			// Save all objects in a single transaction, objects with pre-allocated
+			// primary keys (see IdAllocator) can be saved in any order.
+			bool ownsTransaction = sqlite3_get_autocommit(db) != 0;
+			if (ownsTransaction) executeQuery("BEGIN TRANSACTION;");
+
+			try
 			{
-				queryStream << getInsertQuery(&table, object);
+				for (auto& object : objects)
+				{
+					saveEntry(object);
+				}
+
+				if (ownsTransaction) executeQuery("COMMIT;");
 			}
-			else
+			catch (const std::exception&)
 			{
-				queryStream << getUpdateQuery(&table, object);
+				if (ownsTransaction) sqlite3_exec(db, "ROLLBACK;", NULL, NULL, NULL);
+				throw;
 			}
+		}
 
-			// Run query
-			int result = sqlite3_exec(db, queryStream.str().c_str(), NULL, NULL, &_errorMessage);
-			if (result != SQLITE_OK)
+		int Sqlite3Database::reserveIds(DatabaseTable* tableData, int count)
+		{
+			if (!_connectionOpen)
 			{
-				std::string errMessage = std::string(_errorMessage) + ", using the query: " + queryStream.str();
-				carousel::logging::CarouselLogger::instance().Info(errMessage);
-				throw carousel::exceptions::DatabaseQueryFailed(errMessage);
+				carousel::logging::CarouselLogger::instance().warning("Reserving ids failed because there is currently no open connection.");
+				throw carousel::exceptions::DatabaseNotConnectedException();
 			}
 
-			// Update primary key value
-			if (isNew && table.hasPrimaryKey())
+			// The reserved range is stored in sqlite_sequence, the same sequence used by
+			// AUTOINCREMENT. This way entries saved without a pre-allocated primary key
+			// never collide with the reserved range.
+			std::string tableName = tableData->getTableName();
+			bool ownsTransaction = sqlite3_get_autocommit(db) != 0;
+			if (ownsTransaction) executeQuery("BEGIN IMMEDIATE TRANSACTION;");
+
+			int firstId{ carousel::data::DEFAULT_ID };
+			try
 			{
-				table.getPrimaryKey()->setValue(object, getLastPrimaryKey(&table));
+				std::vector<int> sequence = getIdList("SELECT seq FROM sqlite_sequence WHERE name = '" + tableName + "';");
+				if (sequence.empty())
+				{
+					// Table has not used the sequence yet
+					std::vector<int> maxId = getIdList("SELECT IFNULL(MAX(" + tableData->getPrimaryKey()->getName() + "), 0) FROM '" + tableName + "';");
+					firstId = maxId.front() + 1;
+					executeQuery("INSERT INTO sqlite_sequence (name, seq) VALUES ('" + tableName + "', " + std::to_string(firstId + count - 1) + ");");
+				}
+				else
+				{
+					firstId = sequence.front() + 1;
+					executeQuery("UPDATE sqlite_sequence SET seq = " + std::to_string(firstId + count - 1) + " WHERE name = '" + tableName + "';");
+				}
+
+				if (ownsTransaction) executeQuery("COMMIT;");
 			}
+			catch (const std::exception&)
+			{
+				if (ownsTransaction) sqlite3_exec(db, "ROLLBACK;", NULL, NULL, NULL);
+				throw;
+			}
+
+			return firstId;
 		}
 
-		void Sqlite3Database::save(std::vector<IDatabaseObject*> objects)
+		void Sqlite3Database::remove(IDatabaseObject* object)
+		{
+			DatabaseTable& table = object->get_table_structure();
+			carousel::logging::CarouselLogger::instance().Info("Removing IDatabaseObject: " + table.getTableName());
+
+			// Data that is not linked by foreign keys
+			object->remove_dependent_data();
+
+			// Remove entry and dependent data
+			DatabaseColumn* primaryKey = table.getPrimaryKey();
+			int id = carousel::helpers::converters::convertFromString<int>(primaryKey->getValue(object));
+			remove(&table, { id });
+
+			// Entry is not contained in the database anymore
+			primaryKey->setValue(object, std::to_string(carousel::data::DEFAULT_ID));
+		}
+
+		void Sqlite3Database::remove(DatabaseTable* tableData, const std::vector<int>& ids)
+		{
+			if (!_connectionOpen)
+			{
+				carousel::logging::CarouselLogger::instance().warning("Removing entries failed because there is currently no open connection.");
+				throw carousel::exceptions::DatabaseNotConnectedException();
+			}
+
+			if (ids.empty()) return;
+
+			// Dependencies are obtained from the schema, this way tables that are
+			// not known at runtime are also removed.
+			std::map<std::string, std::vector<DependentTable>> graph = getDependencyGraph();
+			std::string primaryKey = tableData->getPrimaryKey()->getName();
+
+			// Remove in chunks, each chunk is removed in a single transaction
+			// unless the caller already opened one
+			for (auto first = ids.begin(); first != ids.end();)
+			{
+				auto last = ids.end() - first > ID_CHUNK_SIZE ? first + ID_CHUNK_SIZE : ids.end();
+				std::vector<int> chunk(first, last);
+
+				bool ownsTransaction = sqlite3_get_autocommit(db) != 0;
+				if (ownsTransaction) executeQuery("BEGIN TRANSACTION;");
+				try
+				{
+					std::vector<std::string> path{ tableData->getTableName() };
+					removeDependentData(graph, tableData->getTableName(), chunk, path);
+					executeQuery("DELETE FROM \'" + tableData->getTableName() + "\' WHERE " + primaryKey + " IN (" + to_id_list(chunk.begin(), chunk.end()) + ");");
+					if (ownsTransaction) executeQuery("COMMIT;");
+				}
+				catch (const std::exception&)
+				{
+					if (ownsTransaction) sqlite3_exec(db, "ROLLBACK;", NULL, NULL, NULL);
+					throw;
+				}
+
+				first = last;
+			}
+
+			carousel::logging::CarouselLogger::instance().Info("Removed " + std::to_string(ids.size()) + " entries from " + tableData->getTableName() + ".");
+		}
+
+
+
+		void Sqlite3Database::createSummaryTables()
+		{
+			EquilibriumSummary equilibriumSummary;
+			PrecipitationSummary precipitationSummary;
+			std::string equilibriumTable = equilibriumSummary.get_table_structure().getTableName();
+			std::string precipitationTable = precipitationSummary.get_table_structure().getTableName();
+
+			// Summary tables, one entry per summarized group
+			createTable(&equilibriumSummary.get_table_structure());
+			createTable(&precipitationSummary.get_table_structure());
+			executeQuery("CREATE UNIQUE INDEX IF NOT EXISTS '" + equilibriumTable + "_Group' ON '" + equilibriumTable + "' (IDCase);");
+			executeQuery("CREATE UNIQUE INDEX IF NOT EXISTS '" + precipitationTable + "_Group' ON '" + precipitationTable + "' (IDPrecipitationPhase, IDHeatTreatment);");
+
+			// Equilibrium: solvus temperature is the highest temperature with a phase fraction
+			if (containsTable(EquilibriumSummary::SourceTable))
+			{
+				// Recomputes the group of the OLD or NEW row, inserts can update the summary incrementally
+				auto recomputeEquilibrium = [&](const std::string& row)
+				{
+					return "DELETE FROM '" + equilibriumTable + "' WHERE IDCase = " + row + ".IDCase; "
+						"INSERT INTO '" + equilibriumTable + "' (IDCase, SolvusTemperature) "
+						"SELECT IDCase, MAX(Temperature) FROM '" + EquilibriumSummary::SourceTable + "' "
+						"WHERE IDCase = " + row + ".IDCase AND Value > 0 GROUP BY IDCase; ";
+				};
+
+				executeQuery("CREATE TRIGGER IF NOT EXISTS '" + equilibriumTable + "_Insert' AFTER INSERT ON '" + EquilibriumSummary::SourceTable + "' "
+					"WHEN NEW.Value > 0 BEGIN "
+					"INSERT INTO '" + equilibriumTable + "' (IDCase, SolvusTemperature) VALUES (NEW.IDCase, NEW.Temperature) "
+					"ON CONFLICT(IDCase) DO UPDATE SET SolvusTemperature = MAX(SolvusTemperature, excluded.SolvusTemperature); "
+					"END;");
+				executeQuery("CREATE TRIGGER IF NOT EXISTS '" + equilibriumTable + "_Update' AFTER UPDATE OF IDCase, Temperature, Value ON '" + EquilibriumSummary::SourceTable + "' BEGIN " +
+					recomputeEquilibrium("OLD") + recomputeEquilibrium("NEW") +
+					"END;");
+
+				// Only rows that define the solvus temperature change the summary
+				executeQuery("CREATE TRIGGER IF NOT EXISTS '" + equilibriumTable + "_Delete' AFTER DELETE ON '" + EquilibriumSummary::SourceTable + "' "
+					"WHEN OLD.Value > 0 AND OLD.Temperature >= (SELECT SolvusTemperature FROM '" + equilibriumTable + "' WHERE IDCase = OLD.IDCase) BEGIN " +
+					recomputeEquilibrium("OLD") +
+					"END;");
+			}
+			else
+			{
+				carousel::logging::CarouselLogger::instance().warning("Summary " + equilibriumTable + " is not maintained, table " + EquilibriumSummary::SourceTable + " does not exist.");
+			}
+
+			// Precipitation: mean radius at the last time step and peak phase fraction
+			if (containsTable(PrecipitationSummary::SourceTable))
+			{
+				// Recomputes the group of the OLD or NEW row. Note: Bare column MeanRadius is taken from the row that contains MAX(Time)
+				auto recomputePrecipitation = [&](const std::string& row)
+				{
+					std::string group = "IDPrecipitationPhase = " + row + ".IDPrecipitationPhase AND IDHeatTreatment = " + row + ".IDHeatTreatment";
+					return "DELETE FROM '" + precipitationTable + "' WHERE " + group + "; "
+						"INSERT INTO '" + precipitationTable + "' (IDPrecipitationPhase, IDHeatTreatment, FinalTime, FinalMeanRadius, PeakPhaseFraction) "
+						"SELECT IDPrecipitationPhase, IDHeatTreatment, MAX(Time), MeanRadius, "
+						"(SELECT MAX(PhaseFraction) FROM '" + PrecipitationSummary::SourceTable + "' WHERE " + group + ") "
+						"FROM '" + PrecipitationSummary::SourceTable + "' WHERE " + group + " GROUP BY IDPrecipitationPhase, IDHeatTreatment; ";
+				};
+
+				executeQuery("CREATE TRIGGER IF NOT EXISTS '" + precipitationTable + "_Insert' AFTER INSERT ON '" + PrecipitationSummary::SourceTable + "' BEGIN "
+					"INSERT INTO '" + precipitationTable + "' (IDPrecipitationPhase, IDHeatTreatment, FinalTime, FinalMeanRadius, PeakPhaseFraction) "
+					"VALUES (NEW.IDPrecipitationPhase, NEW.IDHeatTreatment, NEW.Time, NEW.MeanRadius, NEW.PhaseFraction) "
+					"ON CONFLICT(IDPrecipitationPhase, IDHeatTreatment) DO UPDATE SET "
+					"FinalMeanRadius = CASE WHEN excluded.FinalTime >= FinalTime THEN excluded.FinalMeanRadius ELSE FinalMeanRadius END, "
+					"FinalTime = MAX(FinalTime, excluded.FinalTime), "
+					"PeakPhaseFraction = MAX(PeakPhaseFraction, excluded.PeakPhaseFraction); "
+					"END;");
+				executeQuery("CREATE TRIGGER IF NOT EXISTS '" + precipitationTable + "_Update' AFTER UPDATE OF IDPrecipitationPhase, IDHeatTreatment, Time, MeanRadius, PhaseFraction ON '" + PrecipitationSummary::SourceTable + "' BEGIN " +
+					recomputePrecipitation("OLD") + recomputePrecipitation("NEW") +
+					"END;");
+
+				// Only rows of the last time step or with the peak phase fraction change the summary
+				executeQuery("CREATE TRIGGER IF NOT EXISTS '" + precipitationTable + "_Delete' AFTER DELETE ON '" + PrecipitationSummary::SourceTable + "' "
+					"WHEN EXISTS (SELECT 1 FROM '" + precipitationTable + "' WHERE IDPrecipitationPhase = OLD.IDPrecipitationPhase AND IDHeatTreatment = OLD.IDHeatTreatment "
+					"AND (OLD.Time >= FinalTime OR OLD.PhaseFraction >= PeakPhaseFraction)) BEGIN " +
+					recomputePrecipitation("OLD") +
+					"END;");
+			}
+			else
+			{
+				carousel::logging::CarouselLogger::instance().warning("Summary " + precipitationTable + " is not maintained, table " + PrecipitationSummary::SourceTable + " does not exist.");
+			}
+		}
+
+		void Sqlite3Database::rebuildSummaryTables()
 		{
-			std::vector<IDatabaseObject*> constraintPrimaryKey;
-			std::vector<IDatabaseObject*> constraintUnique;
+			std::string equilibriumTable = EquilibriumSummary().get_table_structure().getTableName();
+			std::string precipitationTable = PrecipitationSummary().get_table_structure().getTableName();
+
+			// Make sure summary tables and triggers exist
+			createSummaryTables();
 
-			for (auto& object : objects)
+			bool ownsTransaction = sqlite3_get_autocommit(db) != 0;
+			if (ownsTransaction) executeQuery("BEGIN TRANSACTION;");
+			try
 			{
+				if (containsTable(EquilibriumSummary::SourceTable))
+				{
+					executeQuery("DELETE FROM '" + equilibriumTable + "';");
+					executeQuery("INSERT INTO '" + equilibriumTable + "' (IDCase, SolvusTemperature) "
+						"SELECT IDCase, MAX(Temperature) FROM '" + EquilibriumSummary::SourceTable + "' WHERE Value > 0 GROUP BY IDCase;");
+				}
+
+				if (containsTable(PrecipitationSummary::SourceTable))
+				{
+					// Note: Bare column MeanRadius is taken from the row that contains MAX(Time)
+					executeQuery("DELETE FROM '" + precipitationTable + "';");
+					executeQuery("INSERT INTO '" + precipitationTable + "' (IDPrecipitationPhase, IDHeatTreatment, FinalTime, FinalMeanRadius, PeakPhaseFraction) "
+						"SELECT final.IDPrecipitationPhase, final.IDHeatTreatment, final.FinalTime, final.MeanRadius, peak.PeakPhaseFraction FROM "
+						"(SELECT IDPrecipitationPhase, IDHeatTreatment, MAX(Time) AS FinalTime, MeanRadius FROM '" + PrecipitationSummary::SourceTable + "' GROUP BY IDPrecipitationPhase, IDHeatTreatment) AS final "
+						"JOIN (SELECT IDPrecipitationPhase, IDHeatTreatment, MAX(PhaseFraction) AS PeakPhaseFraction FROM '" + PrecipitationSummary::SourceTable + "' GROUP BY IDPrecipitationPhase, IDHeatTreatment) AS peak "
+						"USING (IDPrecipitationPhase, IDHeatTreatment);");
+				}
 
+				if (ownsTransaction) executeQuery("COMMIT;");
 			}
-			// Get SQL queries
-			// Sepparate from update to new
-			// sepparate from constraint type
+			catch (const std::exception&)
+			{
+				if (ownsTransaction) sqlite3_exec(db, "ROLLBACK;", NULL, NULL, NULL);
+				throw;
+			}
+
+			carousel::logging::CarouselLogger::instance().Info("Summary tables were rebuilt successfully.");
 		}
 
+		std::vector<std::vector<std::string>> Sqlite3Database::getRawData(DatabaseTable* tableData, const std::string& columnName, const std::vector<int>& values)
+		{
+			if (!_connectionOpen)
+			{
+				carousel::logging::CarouselLogger::instance().warning("Loading entries failed because there is currently no open connection.");
+				throw carousel::exceptions::DatabaseNotConnectedException();
+			}
+
+			std::vector<std::vector<std::string>> response;
+			int columnCount = tableData->size();
+			if (values.empty() || columnCount == 0) return response;
+
+			// Select all columns in the order defined by the table
+			std::ostringstream selectStream;
+			selectStream << "SELECT " << tableData->operator[](0)->getName();
+			for (int i = 1; i < columnCount; i++)
+			{
+				selectStream << ", " << tableData->operator[](i)->getName();
+			}
+			selectStream << " FROM \'" << tableData->getTableName() << "\' WHERE " << columnName << " IN (";
+
+			// Load in chunks, this keeps the query size bounded
+			for (auto first = values.begin(); first != values.end();)
+			{
+				auto last = values.end() - first > ID_CHUNK_SIZE ? first + ID_CHUNK_SIZE : values.end();
+				std::string query = selectStream.str() + to_id_list(first, last) + ");";
+
+				sqlite3_stmt* stmt;
+				int returnCode = sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, 0);
+				if (returnCode != SQLITE_OK)
+				{
+					std::string errMessage = std::string(sqlite3_errmsg(db)) + ", using the query: " + query;
+					carousel::logging::CarouselLogger::instance().warning(errMessage);
+					throw carousel::exceptions::DatabaseQueryFailed(errMessage);
+				}
 
+				while (sqlite3_step(stmt) == SQLITE_ROW)
+				{
+					std::vector<std::string> row;
+					row.reserve(columnCount);
+					for (int i = 0; i < columnCount; i++)
+					{
+						const unsigned char* text = sqlite3_column_text(stmt, i);
+						row.push_back(text != nullptr ? reinterpret_cast<const char*>(text) : "");
+					}
+					response.push_back(std::move(row));
+				}
+
+				sqlite3_finalize(stmt);
+				first = last;
+			}
+
+			return response;
+		}
 #pragma endregion
 
 #pragma region Helpers
+		void Sqlite3Database::saveEntry(IDatabaseObject* object)
+		{
+			DatabaseTable& table = object->get_table_structure();
+
+			// Objects with an assigned primary key are either stored or have a pre-allocated key,
+			// both cases are handled by an upsert.
+			bool isAssignedKey = table.hasPrimaryKey() && table.getPrimaryKey()->getValue(object) != std::to_string(carousel::data::DEFAULT_ID);
+			bool isNew = !isAssignedKey && isNewEntry(&table, object);
+
+			// Build query
+			std::string query;
+			if (isAssignedKey)
+			{
+				query = getUpsertQuery(&table, object);
+			}
+			else if (isNew)
+			{
+				query = getInsertQuery(&table, object);
+			}
+			else
+			{
+				query = getUpdateQuery(&table, object);
+			}
+
+			// Run query
+			executeQuery(query);
+
+			// Update primary key value
+			if (isNew && table.hasPrimaryKey())
+			{
+				table.getPrimaryKey()->setValue(object, getLastPrimaryKey(&table));
+			}
+		}
+
 		std::string Sqlite3Database::getInsertQuery(DatabaseTable* const tableData, IDatabaseObject* object)
 		{
 			// Get columns that are not auto-generated
-			std::vector<DatabaseColumn*> columns = tableData->getColumnsByConstraint(DatabaseConstraintType::COLUMN | DatabaseConstraintType::UNIQUE);
+			std::vector<DatabaseColumn*> columns = tableData->getColumnsByConstraint(DatabaseConstraintType::COLUMN | DatabaseConstraintType::UNIQUE | DatabaseConstraintType::FOREIGN_KEY);
 
 			// Query 
 			std::ostringstream queryStream;
 
 			// Add column names
-			queryStream << "INSERT INTO \'" << tableData->getTableName() << "\' ( " << columns[0];
+			queryStream << "INSERT INTO \'" << tableData->getTableName() << "\' ( " << columns[0]->getName();
 			for (size_t i = 1; i < columns.size(); i++)
 			{
 				queryStream << ", " << columns[i]->getName();
@@ -259,10 +564,51 @@ namespace carousel
 			return queryStream.str();
 		}
 
+		std::string Sqlite3Database::getUpsertQuery(DatabaseTable* const tableData, IDatabaseObject* object)
+		{
+			DatabaseColumn* primaryKey = tableData->getPrimaryKey();
+			std::vector<DatabaseColumn*> columns = tableData->getColumnsByConstraint(DatabaseConstraintType::COLUMN | DatabaseConstraintType::UNIQUE | DatabaseConstraintType::FOREIGN_KEY);
+
+			// Query
+			std::ostringstream queryStream;
+
+			// Add column names, primary key first
+			queryStream << "INSERT INTO \'" << tableData->getTableName() << "\' ( " << primaryKey->getName();
+			for (const auto& column : columns)
+			{
+				queryStream << ", " << column->getName();
+			}
+			queryStream << " ) VALUES ( " << primaryKey->getValue(object);
+
+			// Add Column values
+			for (const auto& column : columns)
+			{
+				queryStream << ", \'" << column->getValue(object) << "\'";
+			}
+
+			// Update existing entry
+			queryStream << " ) ON CONFLICT(" << primaryKey->getName() << ") DO ";
+			if (columns.empty())
+			{
+				queryStream << "NOTHING;";
+				return queryStream.str();
+			}
+
+			queryStream << "UPDATE SET ";
+			for (size_t i = 0; i < columns.size(); i++)
+			{
+				if (i > 0) queryStream << ", ";
+				queryStream << columns[i]->getName() << " = excluded." << columns[i]->getName();
+			}
+			queryStream << ";";
+
+			return queryStream.str();
+		}
+
 		std::string Sqlite3Database::getUpdateQuery(DatabaseTable* const tableData, IDatabaseObject* object)
 		{
 			// Get columns that are not auto-generated
-			std::vector<DatabaseColumn*> columns = tableData->getColumnsByConstraint(DatabaseConstraintType::COLUMN);
+			std::vector<DatabaseColumn*> columns = tableData->getColumnsByConstraint(DatabaseConstraintType::COLUMN | DatabaseConstraintType::FOREIGN_KEY);
 
 			// Query
 			std::ostringstream queryStream;
@@ -301,25 +647,9 @@ namespace carousel
 
 		std::string Sqlite3Database::getLastPrimaryKey(DatabaseTable* const tableData)
 		{
-			std::string Query = "SELECT " + tableData->getPrimaryKey()->getName() + " FROM \'" + tableData->getTableName() + "\' ORDER BY ID DESC LIMIT 1 ";
-			std::string Response{ "-1" };
-			sqlite3_stmt* stmt;
-
-			int exec_result = sqlite3_prepare_v2(db, Query.c_str(), -1, &stmt, 0);
-			if (exec_result == SQLITE_OK) {
-
-				while (sqlite3_step(stmt) == SQLITE_ROW)
-				{
-					std::stringstream ss;
-					std::string TName;
-					ss << sqlite3_column_text(stmt, 0);
-					ss >> TName;
-					Response = TName;
-				}
-			}
-
-			sqlite3_finalize(stmt);
-			return Response;
+			// Rowid of the last insert on this connection, the highest key in the table can
+			// belong to a pre-allocated range (see reserveIds)
+			return std::to_string(sqlite3_last_insert_rowid(db));
 		}
 
 		int Sqlite3Database::getCountForUniqueConstraint(DatabaseTable* const tableData, IDatabaseObject* object)
@@ -365,6 +695,130 @@ namespace carousel
 			return Response;
 		}
 
+		void Sqlite3Database::executeQuery(const std::string& query)
+		{
+			int result = sqlite3_exec(db, query.c_str(), NULL, NULL, &_errorMessage);
+			if (result != SQLITE_OK)
+			{
+				std::string errMessage = std::string(_errorMessage) + ", using the query: " + query;
+				sqlite3_free(_errorMessage);
+				_errorMessage = nullptr;
+				carousel::logging::CarouselLogger::instance().warning(errMessage);
+				throw carousel::exceptions::DatabaseQueryFailed(errMessage);
+			}
+		}
+
+		std::vector<int> Sqlite3Database::getIdList(const std::string& query)
+		{
+			std::vector<int> response;
+			sqlite3_stmt* stmt;
+
+			int returnCode = sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, 0);
+			if (returnCode != SQLITE_OK)
+			{
+				std::string errMessage = std::string(sqlite3_errmsg(db)) + ", using the query: " + query;
+				carousel::logging::CarouselLogger::instance().warning(errMessage);
+				throw carousel::exceptions::DatabaseQueryFailed(errMessage);
+			}
+
+			while (sqlite3_step(stmt) == SQLITE_ROW)
+			{
+				response.push_back(sqlite3_column_int(stmt, 0));
+			}
+
+			sqlite3_finalize(stmt);
+			return response;
+		}
+
+		std::map<std::string, std::vector<Sqlite3Database::DependentTable>> Sqlite3Database::getDependencyGraph()
+		{
+			std::map<std::string, std::vector<DependentTable>> graph;
+
+			for (const auto& tableName : getTableNames())
+			{
+				// Primary key of the dependent table
+				std::string primaryKey{ "" };
+				sqlite3_stmt* stmt;
+				std::string query = "PRAGMA table_info('" + tableName + "')";
+				if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, 0) == SQLITE_OK)
+				{
+					// columns: cid, name, type, notnull, dflt_value, pk
+					while (sqlite3_step(stmt) == SQLITE_ROW)
+					{
+						if (sqlite3_column_int(stmt, 5) == 1)
+						{
+							primaryKey = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+						}
+					}
+				}
+				sqlite3_finalize(stmt);
+
+				// Foreign keys, each one is an edge from the parent table to this table
+				query = "PRAGMA foreign_key_list('" + tableName + "')";
+				if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, 0) == SQLITE_OK)
+				{
+					// columns: id, seq, table, from, to, on_update, on_delete, match
+					while (sqlite3_step(stmt) == SQLITE_ROW)
+					{
+						std::string parentTable = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+						std::string foreignKey = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+						graph[parentTable].push_back({ tableName, foreignKey, primaryKey });
+					}
+				}
+				sqlite3_finalize(stmt);
+			}
+
+			return graph;
+		}
+
+		void Sqlite3Database::removeDependentData(const std::map<std::string, std::vector<DependentTable>>& graph, const std::string& tableName, const std::vector<int>& ids, std::vector<std::string>& path)
+		{
+			auto entry = graph.find(tableName);
+			if (entry == graph.end()) return;
+
+			std::string idList = to_id_list(ids.begin(), ids.end());
+			for (const auto& dependent : entry->second)
+			{
+				// Skip circular references
+				if (std::find(path.begin(), path.end(), dependent.tableName) != path.end()) continue;
+
+				// Dependent table has its own dependencies, these have to be removed first. Only the
+				// ids of tables that have dependencies are queried, leaf tables are removed directly.
+				if (graph.count(dependent.tableName) > 0 && !dependent.primaryKey.empty())
+				{
+					std::vector<int> dependentIds = getIdList("SELECT " + dependent.primaryKey + " FROM '" + dependent.tableName + "' WHERE " + dependent.foreignKey + " IN (" + idList + ");");
+
+					path.push_back(dependent.tableName);
+					for (auto first = dependentIds.cbegin(); first != dependentIds.cend();)
+					{
+						auto last = dependentIds.cend() - first > ID_CHUNK_SIZE ? first + ID_CHUNK_SIZE : dependentIds.cend();
+						removeDependentData(graph, dependent.tableName, std::vector<int>(first, last), path);
+						first = last;
+					}
+					path.pop_back();
+				}
+
+				executeQuery("DELETE FROM '" + dependent.tableName + "' WHERE " + dependent.foreignKey + " IN (" + idList + ");");
+			}
+		}
+
+		bool Sqlite3Database::containsTable(const std::string& tableName)
+		{
+			std::vector<std::string> tableNames = getTableNames();
+			return std::find(tableNames.begin(), tableNames.end(), tableName) != tableNames.end();
+		}
+
+		std::string Sqlite3Database::to_id_list(std::vector<int>::const_iterator first, std::vector<int>::const_iterator last)
+		{
+			std::ostringstream idStream;
+			for (auto it = first; it != last; ++it)
+			{
+				if (it != first) idStream << ", ";
+				idStream << *it;
+			}
+			return idStream.str();
+		}
+
 		std::string Sqlite3Database::string_to_database_format(const std::string& typeidName, const std::string& value)
 		{
 			if (typeidName == typeid(std::string).name())
@@ -393,5 +847,4 @@ namespace carousel
 		}
 #pragma endregion
 	}
-}
-
+}
\ No newline at end of file
@@ -0,0 +1,300 @@
+#include "../../../include/IpcTools/IpcDispatcher.h"
+#include "../../../include/Exceptions/IpcCommunicationException.h"
+#include <algorithm>
+
+namespace carousel
+{
+	namespace ipcTools
+	{
+		namespace
+		{
+			/// <summary>
+			/// Marks the ids of the in pipes, they only wake the dispatcher up. Sessions are updated on every iteration.
+			/// </summary>
+			constexpr uint64_t WRITABLE_ID = static_cast<uint64_t>(1) << 62;
+		}
+
+#pragma region Constructor&Destructor
+		IpcDispatcher::IpcDispatcher() : _thread(&IpcDispatcher::run, this)
+		{
+			// Empty
+		}
+
+		IpcDispatcher::~IpcDispatcher()
+		{
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_stopping = true;
+			}
+			_waiter.wake();
+			_thread.join();
+
+			// Processes stay alive, only their commands fail
+			std::lock_guard<std::mutex> lock(_mutex);
+			for (auto& session : _sessions)
+			{
+				close(session.second, "IpcDispatcher - Dispatcher was stopped.", false);
+			}
+			_sessions.clear();
+			_sessionIds.clear();
+		}
+#pragma endregion
+
+#pragma region Methods
+		std::future<std::string> IpcDispatcher::sendAsync(IpcPipeHandler& handler, std::string command, std::chrono::milliseconds timeout, std::shared_ptr<IpcCancellation> cancellation)
+		{
+			Request request;
+			request.command = std::move(command);
+			request.timeout = timeout;
+			request.cancellation = std::move(cancellation);
+			std::future<std::string> result = request.result.get_future();
+
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				if (_stopping || !handler.isReady())
+				{
+					request.result.set_exception(std::make_exception_ptr(carousel::exceptions::IpcCommunicationException("IpcDispatcher::sendAsync - Communication to process is broken.")));
+					return result;
+				}
+
+				// First command of the process registers it
+				auto sessionId = _sessionIds.find(&handler);
+				if (sessionId == _sessionIds.end())
+				{
+					uint64_t id = _nextSessionId++;
+					_waiter.add(handler.notificationHandle(), id);
+					_sessions.emplace(id, Session{ &handler, {}, id });
+					sessionId = _sessionIds.emplace(&handler, id).first;
+					handler._dispatcher = this;
+				}
+
+				if (request.cancellation)
+				{
+					request.cancellation->setCallback([this]() { _waiter.wake(); });
+				}
+
+				_sessions.at(sessionId->second).requests.push_back(std::move(request));
+			}
+
+			_waiter.wake();
+			return result;
+		}
+
+		void IpcDispatcher::remove(IpcPipeHandler& handler)
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			auto sessionId = _sessionIds.find(&handler);
+			if (sessionId == _sessionIds.end()) return;
+
+			auto session = _sessions.find(sessionId->second);
+			close(session->second, "IpcDispatcher - Process was closed.", false);
+			_sessions.erase(session);
+			_sessionIds.erase(sessionId);
+
+			// The dispatcher thread may still be waiting on the handle of the process
+			if (std::this_thread::get_id() != _thread.get_id() && !_stopping)
+			{
+				uint64_t iteration = _iteration + 1;
+				_waiter.wake();
+				_iterationDone.wait(lock, [this, iteration]() { return _iteration >= iteration || _stopping; });
+			}
+		}
+
+		size_t IpcDispatcher::pendingCount()
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			size_t count{ 0 };
+			for (const auto& session : _sessions)
+			{
+				count += session.second.requests.size();
+			}
+
+			return count;
+		}
+#pragma endregion
+
+#pragma region Private_helpers
+		void IpcDispatcher::run()
+		{
+			std::vector<uint64_t> ready;
+			std::unique_lock<std::mutex> lock(_mutex);
+
+			while (!_stopping)
+			{
+				auto now = std::chrono::steady_clock::now();
+
+				for (auto session = _sessions.begin(); session != _sessions.end();)
+				{
+					bool readable = std::find(ready.begin(), ready.end(), session->first) != ready.end();
+					if (update(session->second, readable, now))
+					{
+						++session;
+					}
+					else
+					{
+						_sessionIds.erase(session->second.handler);
+						session = _sessions.erase(session);
+					}
+				}
+
+				// Wait until data arrives, a command is queued or the next deadline
+				int waitTime = -1;
+				for (const auto& session : _sessions)
+				{
+					const auto& requests = session.second.requests;
+					if (requests.empty() || !requests.front().sent) continue;
+
+					auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(requests.front().deadline - now).count() + 1;
+					int remainingTime = static_cast<int>(std::max<long long>(0, remaining));
+					waitTime = waitTime < 0 ? remainingTime : std::min(waitTime, remainingTime);
+				}
+
+				_iteration++;
+				_iterationDone.notify_all();
+
+				ready.clear();
+				lock.unlock();
+				_waiter.wait(waitTime, ready);
+				lock.lock();
+			}
+
+			_iterationDone.notify_all();
+		}
+
+		bool IpcDispatcher::update(Session& session, bool readable, std::chrono::steady_clock::time_point now)
+		{
+			IpcPipeHandler& handler = *session.handler;
+			bool outputClosed{ false };
+
+			if (readable)
+			{
+				try
+				{
+					handler.receive();
+				}
+				catch (const carousel::exceptions::IpcCommunicationException&)
+				{
+					outputClosed = true;
+				}
+			}
+
+			// Queued commands that were cancelled are dropped
+			for (auto request = session.requests.begin(); request != session.requests.end();)
+			{
+				if (!request->sent && request->cancellation && request->cancellation->isCancelled())
+				{
+					request->result.set_exception(std::make_exception_ptr(carousel::exceptions::IpcCommunicationException("IpcDispatcher - Command was cancelled.")));
+					request = session.requests.erase(request);
+				}
+				else
+				{
+					++request;
+				}
+			}
+
+			// Complete the running command and send the next one
+			std::string message;
+			while (!session.requests.empty())
+			{
+				Request& request = session.requests.front();
+				bool starting = !request.sent;
+
+				if (starting)
+				{
+					if (outputClosed) break;
+
+					request.sent = true;
+					request.deadline = now + request.timeout;
+				}
+
+				// Written as far as the pipe takes it, the rest once the process reads its input
+				bool written = request.written == request.command.length();
+				if (starting || !written)
+				{
+					try
+					{
+						request.written = handler.sendAvailable(request.command, request.written);
+						written = request.written == request.command.length();
+
+						// The dispatcher is woken up once the process reads
+						if (!written && !session.writeWatched)
+						{
+							_waiter.addWritable(handler.writeNotificationHandle(), session.id | WRITABLE_ID);
+							session.writeWatched = true;
+						}
+						else if (written && session.writeWatched)
+						{
+							_waiter.remove(handler.writeNotificationHandle());
+							session.writeWatched = false;
+						}
+					}
+					catch (const std::exception& e)
+					{
+						close(session, std::string("IpcDispatcher - Command could not be sent: ") + e.what(), true);
+						return false;
+					}
+				}
+
+				if (written && handler.popMessage(message))
+				{
+					request.result.set_value(std::move(message));
+					session.requests.pop_front();
+					continue;
+				}
+
+				// Running command that can't complete anymore, the process is in an unknown state
+				if (request.cancellation && request.cancellation->isCancelled())
+				{
+					close(session, "IpcDispatcher - Command was cancelled, the process was terminated.", true);
+					return false;
+				}
+
+				if (now >= request.deadline)
+				{
+					close(session, "IpcDispatcher - Command did not complete within its timeout, the process was terminated.", true);
+					return false;
+				}
+
+				break;
+			}
+
+			if (outputClosed)
+			{
+				close(session, "IpcDispatcher - Process closed its output.", true);
+				return false;
+			}
+
+			// Sessions without commands are unregistered, the process can be used synchronously again.
+			// The last response was handed out above, the handler is not touched after that.
+			if (session.requests.empty())
+			{
+				_waiter.remove(handler.notificationHandle());
+				handler._dispatcher = nullptr;
+				return false;
+			}
+
+			return true;
+		}
+
+		void IpcDispatcher::close(Session& session, const std::string& message, bool terminate)
+		{
+			IpcPipeHandler& handler = *session.handler;
+			_waiter.remove(handler.notificationHandle());
+			if (session.writeWatched) _waiter.remove(handler.writeNotificationHandle());
+			session.writeWatched = false;
+
+			// Process is closed before the commands fail
+			if (terminate) handler.closeProcess();
+
+			for (auto& request : session.requests)
+			{
+				request.result.set_exception(std::make_exception_ptr(carousel::exceptions::IpcCommunicationException(message)));
+			}
+			session.requests.clear();
+
+			// Detached last, a concurrent destructor waits in remove until the process is closed
+			handler._dispatcher = nullptr;
+		}
+#pragma endregion
+	}
+}
\ No newline at end of file
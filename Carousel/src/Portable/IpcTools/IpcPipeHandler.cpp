@@ -1,44 +1,313 @@
 #pragma once
 #include "../../../include/IpcTools/IpcPipeHandler.h"
+#include "../../../include/IpcTools/IpcDispatcher.h"
 #include "../../../include/Exceptions/IpcCommunicationException.h"
-#include <thread>
-#include <future>
+#include <chrono>
+#include <deque>
 
 namespace carousel
 {
 	namespace ipcTools
 	{
-#pragma region private_helpers
-		void IpcPipeHandler::waitUntilReady()
-		{	
-			if (_processReady) return;
+#pragma region Methods
+		void IpcPipeHandler::send(const std::string& command)
+		{
+			waitUntilReady();
+			writeToPipe(command, _pipeWriteIn);
+			_pendingResponses++;
+		}
+
+		std::string IpcPipeHandler::read()
+		{
+			// Make sure proccess is ready
+			waitUntilReady();
+
+			// Responses that were already received are handed out even if the process has exited
+			if (!_receiveBuffer.hasMessage() && !isReady())
+			{
+				// Connection is broken
+				throw carousel::exceptions::IpcCommunicationException("IpcPipeHandler::read - Communication to process is broken.");
+			}
+
+			// If a command awaits its response, the read blocks until the end flag arrives or the
+			// timeout is reached. Otherwise only the data the process sends within the idle time is read.
+			// Each received byte is scanned once, data that follows the end flag is kept for the next read.
+			bool awaitingResponse = _pendingResponses > 0;
+			auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(_timeout);
 
-			// Setup the task
-			std::promise<bool> promise;
-			std::future<bool> future = promise.get_future();
-			bool keepWaiting{ true };
+			while (!_receiveBuffer.hasMessage())
+			{
+				int waitTime = _idleTime;
+				if (awaitingResponse)
+				{
+					auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+					waitTime = remaining > 0 ? static_cast<int>(remaining) : 0;
+				}
 
-			std::thread waitThread([this, &promise, &keepWaiting]()
+				if (!waitForData(waitTime))
 				{
-					// Wait until process is ready or timeout
-					while (!_processReady && keepWaiting)
+					if (_outputClosed)
+					{
+						throw carousel::exceptions::IpcCommunicationException("IpcPipeHandler::read - Process closed its output.");
+					}
+
+					if (awaitingResponse)
 					{
-						std::this_thread::sleep_for(std::chrono::milliseconds(100));
+						carousel::logging::CarouselLogger::instance().warning("IpcPipeHandler::read - End flag was not received within the expected time.");
 					}
-					promise.set_value(true);
-				});
+					break;
+				}
+
+				if (readFromPipe(_pipeReadOut, _receiveBuffer) == 0) break;
+			}
+
+			if (_receiveBuffer.hasMessage())
+			{
+				if (awaitingResponse) _pendingResponses--;
+				return _receiveBuffer.popMessage();
+			}
+
+			return _receiveBuffer.popAll();
+		}
+
+		bool IpcPipeHandler::readStream(const std::function<void(const std::string&)>& onData)
+		{
+			waitUntilReady();
+
+			if (!_receiveBuffer.hasMessage() && !isReady())
+			{
+				throw carousel::exceptions::IpcCommunicationException("IpcPipeHandler::readStream - Communication to process is broken.");
+			}
+
+			// Long running commands (e.g. precipitation simulations) only time out if they stop sending
+			auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(_timeout);
+
+			while (!_receiveBuffer.hasMessage())
+			{
+				std::string piece = _receiveBuffer.popPartial();
+				if (!piece.empty()) onData(piece);
+
+				auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+				if (!waitForData(remaining > 0 ? static_cast<int>(remaining) : 0))
+				{
+					if (_outputClosed)
+					{
+						throw carousel::exceptions::IpcCommunicationException("IpcPipeHandler::readStream - Process closed its output.");
+					}
+
+					carousel::logging::CarouselLogger::instance().warning("IpcPipeHandler::readStream - End flag was not received within the expected time.");
+					return false;
+				}
+
+				if (readFromPipe(_pipeReadOut, _receiveBuffer) > 0)
+				{
+					deadline = std::chrono::steady_clock::now() + std::chrono::seconds(_timeout);
+				}
+			}
+
+			if (_pendingResponses > 0) _pendingResponses--;
+			onData(_receiveBuffer.popMessage());
+			return true;
+		}
+
+		IpcBatchResult IpcPipeHandler::sendBatch(const std::vector<std::string>& commands, size_t window)
+		{
+			IpcBatchResult result;
+			result.responses.reserve(commands.size());
+			if (window == 0) window = 1;
+
+			// Lengths of the commands awaiting their response. Their total is kept within the pipe buffer,
+			// only a single command that is larger than the buffer is written on its own.
+			std::deque<size_t> inFlight;
+			size_t inFlightBytes = 0;
+			size_t next = 0;
+
+			try
+			{
+				waitUntilReady();
+
+				// Each response may take the timeout, counted from the previous one
+				auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(_timeout);
+
+				// After a failed write only the responses of the commands already sent are collected
+				std::string sendError;
+
+				while (result.responses.size() < commands.size())
+				{
+					while (sendError.empty() && next < commands.size() && inFlight.size() < window && (inFlight.empty() || inFlightBytes + commands[next].length() <= static_cast<size_t>(BUFFER_SIZE)))
+					{
+						try
+						{
+							writeToPipe(commands[next], _pipeWriteIn);
+						}
+						catch (const carousel::exceptions::IpcCommunicationException& e)
+						{
+							sendError = e.what();
+							break;
+						}
+
+						_pendingResponses++;
+						inFlight.push_back(commands[next].length());
+						inFlightBytes += commands[next].length();
+						next++;
+					}
+
+					if (inFlight.empty())
+					{
+						throw carousel::exceptions::IpcCommunicationException(sendError);
+					}
+
+					if (!_receiveBuffer.hasMessage())
+					{
+						auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+						if (!waitForData(remaining > 0 ? static_cast<int>(remaining) : 0))
+						{
+							if (_outputClosed)
+							{
+								throw carousel::exceptions::IpcCommunicationException("IpcPipeHandler::sendBatch - Process closed its output.");
+							}
+
+							throw carousel::exceptions::IpcCommunicationException("IpcPipeHandler::sendBatch - End flag was not received within the expected time.");
+						}
+
+						readFromPipe(_pipeReadOut, _receiveBuffer);
+						continue;
+					}
+
+					// Responses that arrived together are handed out at once
+					while (_receiveBuffer.hasMessage() && !inFlight.empty())
+					{
+						_pendingResponses--;
+						result.responses.push_back(_receiveBuffer.popMessage());
+						inFlightBytes -= inFlight.front();
+						inFlight.pop_front();
+					}
+					deadline = std::chrono::steady_clock::now() + std::chrono::seconds(_timeout);
+				}
+			}
+			catch (const std::exception& e)
+			{
+				result.error = e.what();
+				carousel::logging::CarouselLogger::instance().warning("IpcPipeHandler::sendBatch - Stopped after " + std::to_string(result.responses.size()) + " of " + std::to_string(commands.size()) + " commands, the process is terminated: " + result.error);
+
+				// Late responses of the commands in flight would be taken for the responses of later commands
+				terminate();
+				_pendingResponses = 0;
+				_receiveBuffer.clear();
+			}
+
+			return result;
+		}
+
+		std::future<std::string> IpcPipeHandler::sendAsync(const std::string& command, std::chrono::milliseconds timeout, std::shared_ptr<IpcCancellation> cancellation)
+		{
+			return IpcDispatcher::instance().sendAsync(*this, command, timeout, std::move(cancellation));
+		}
+
+		void IpcPipeHandler::terminate()
+		{
+			detachDispatcher();
+			closeProcess();
+		}
+
+		bool IpcPipeHandler::isDrained()
+		{
+			if (_pendingResponses > 0 || _receiveBuffer.size() > 0) return false;
+
+			return !waitForData(0);
+		}
+#pragma endregion
+
+#pragma region private_helpers
+		void IpcPipeHandler::waitUntilReady()
+		{
+			if (_processReady) return;
 
 			// Wait for process to finish initialization
-			std::future_status status = future.wait_for(std::chrono::seconds(_timeout));
-			
-			// Cleanup
-			keepWaiting = false;
-			waitThread.join();
-			
-			if (status != std::future_status::ready) 
+			std::unique_lock<std::mutex> lock(_stateMutex);
+			bool started = _stateChanged.wait_for(lock, std::chrono::seconds(_timeout), [this]() { return _processStarted; });
+
+			if (!started)
 			{
 				throw carousel::exceptions::IpcCommunicationException("Timeout: Process not ready within the expected time.");
 			}
+
+			if (!_processReady)
+			{
+				throw carousel::exceptions::IpcCommunicationException("IpcPipeHandler - Process could not be initialized.");
+			}
+		}
+
+		bool IpcPipeHandler::waitForInitialization()
+		{
+			if (!waitForData(_timeout * 1000)) return false;
+			size_t bytesRead = readFromPipe(_pipeReadOut, _receiveBuffer);
+
+			// Initialization output ends with the end flag (e.g. the prompt of the process), otherwise
+			// the output is consumed until the process stays silent.
+			while (!_receiveBuffer.hasMessage() && waitForData(_initProcTime))
+			{
+				size_t nextRead = readFromPipe(_pipeReadOut, _receiveBuffer);
+				if (nextRead == 0) break;
+				bytesRead += nextRead;
+			}
+
+			// Initialization output is discarded
+			if (_receiveBuffer.hasMessage())
+			{
+				_receiveBuffer.popMessage();
+			}
+			else
+			{
+				_receiveBuffer.popAll();
+			}
+
+			return bytesRead > 0;
+		}
+
+		size_t IpcPipeHandler::sendAvailable(const std::string& command, size_t offset)
+		{
+			offset += writeAvailable(command.data() + offset, command.length() - offset, _pipeWriteIn);
+			if (offset == command.length()) _pendingResponses++;
+
+			return offset;
+		}
+
+		size_t IpcPipeHandler::receive()
+		{
+			size_t bytesRead = 0;
+			if (waitForData(0)) bytesRead = readFromPipe(_pipeReadOut, _receiveBuffer);
+
+			if (bytesRead == 0 && _outputClosed)
+			{
+				throw carousel::exceptions::IpcCommunicationException("IpcPipeHandler::receive - Process closed its output.");
+			}
+
+			return bytesRead;
+		}
+
+		bool IpcPipeHandler::popMessage(std::string& message)
+		{
+			if (!_receiveBuffer.hasMessage()) return false;
+
+			if (_pendingResponses > 0) _pendingResponses--;
+			message = _receiveBuffer.popMessage();
+			return true;
+		}
+
+		void IpcPipeHandler::detachDispatcher()
+		{
+			IpcDispatcher* dispatcher = _dispatcher.load();
+			if (dispatcher) dispatcher->remove(*this);
+		}
+
+		void IpcPipeHandler::setProcessState(bool ready)
+		{
+			// Notified under the lock, the destructor may be waiting for this state
+			std::lock_guard<std::mutex> lock(_stateMutex);
+			_processReady = ready;
+			_processStarted = true;
+			_stateChanged.notify_all();
 		}
 #pragma endregion
 	}
@@ -0,0 +1,90 @@
+#include "../../../include/IpcTools/IpcEventWaiter.h"
+#include "../../../include/Exceptions/IpcCommunicationException.h"
+#include <Windows.h>
+#include <algorithm>
+
+namespace carousel
+{
+	namespace ipcTools
+	{
+#pragma region Constructor&Destructor
+		IpcEventWaiter::IpcEventWaiter()
+		{
+			// Auto reset, a wake up is consumed by one wait
+			_wakeHandle = CreateEventA(NULL, FALSE, FALSE, NULL);
+
+			if (_wakeHandle == NULL)
+			{
+				throw carousel::exceptions::IpcCommunicationException("IpcEventWaiter - Could not create event, error " + std::to_string(GetLastError()));
+			}
+		}
+
+		IpcEventWaiter::~IpcEventWaiter()
+		{
+			CloseHandle(_wakeHandle);
+		}
+#pragma endregion
+
+#pragma region Methods
+		void IpcEventWaiter::add(SystemHandle handle, uint64_t id)
+		{
+			std::lock_guard<std::mutex> lock(_handlesMutex);
+
+			// One slot is used by the wake handle
+			if (_handles.size() + 1 >= MAXIMUM_WAIT_OBJECTS)
+			{
+				throw carousel::exceptions::IpcCommunicationException("IpcEventWaiter::add - At most " + std::to_string(MAXIMUM_WAIT_OBJECTS - 1) + " handles can be registered.");
+			}
+
+			_handles.emplace_back(handle, id);
+		}
+
+		void IpcEventWaiter::addWritable(SystemHandle handle, uint64_t id)
+		{
+			// Events are signalled the same way for reading and writing
+			add(handle, id);
+		}
+
+		void IpcEventWaiter::remove(SystemHandle handle)
+		{
+			std::lock_guard<std::mutex> lock(_handlesMutex);
+			_handles.erase(std::remove_if(_handles.begin(), _handles.end(), [handle](const auto& entry) { return entry.first == handle; }), _handles.end());
+		}
+
+		void IpcEventWaiter::wait(int timeoutMs, std::vector<uint64_t>& ready)
+		{
+			HANDLE handles[MAXIMUM_WAIT_OBJECTS];
+			uint64_t ids[MAXIMUM_WAIT_OBJECTS];
+			DWORD count = 0;
+
+			handles[count++] = _wakeHandle;
+			{
+				std::lock_guard<std::mutex> lock(_handlesMutex);
+				for (const auto& entry : _handles)
+				{
+					handles[count] = entry.first;
+					ids[count] = entry.second;
+					count++;
+				}
+			}
+
+			DWORD result = WaitForMultipleObjects(count, handles, FALSE, timeoutMs < 0 ? INFINITE : static_cast<DWORD>(timeoutMs));
+			if (result == WAIT_TIMEOUT || result == WAIT_FAILED) return;
+
+			// WaitForMultipleObjects only reports the first signalled handle
+			for (DWORD i = 1; i < count; i++)
+			{
+				if (WaitForSingleObject(handles[i], 0) == WAIT_OBJECT_0)
+				{
+					ready.push_back(ids[i]);
+				}
+			}
+		}
+
+		void IpcEventWaiter::wake()
+		{
+			SetEvent(_wakeHandle);
+		}
+#pragma endregion
+	}
+}
\ No newline at end of file
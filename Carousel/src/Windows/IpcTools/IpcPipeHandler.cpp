@@ -23,20 +23,29 @@ namespace carousel
 			_pipeReadIn = NULL;
 			_processHandle = NULL;
 
-			// Shoot initialization thread
-			std::thread initThread(&IpcPipeHandler::startProcess, this);
-			initThread.detach();
+			// Manual reset, set while collected data is available
+			_dataEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+
+			// Manual reset, set while the writer thread is idle
+			_writeEvent = CreateEventA(NULL, TRUE, TRUE, NULL);
+
+			// Initialization runs on the calling thread, no thread outlives this object
+			startProcess();
 		}
 
 		IpcPipeHandler::~IpcPipeHandler()
 		{
+			detachDispatcher();
 			closeProcess();
+			CloseHandle(_dataEvent);
+			CloseHandle(_writeEvent);
 		}
 #pragma endregion
 
 #pragma region Methods
 		bool IpcPipeHandler::isReady() const
 		{
+			if (!_processReady) return false;
 			DWORD exitCode = STATUS_CONTROL_C_EXIT;
 
 			if (!GetExitCodeProcess(_processHandle, &exitCode))
@@ -46,39 +55,6 @@ namespace carousel
 
 			return _processReady && (exitCode == STILL_ACTIVE);
 		}
-
-		void IpcPipeHandler::send(const std::string& command)
-		{
-			waitUntilReady();
-			writeToPipe(command, _pipeWriteIn);
-		}
-
-		std::string IpcPipeHandler::read()
-		{
-			// Make sure proccess is ready
-			waitUntilReady();
-			std::string result, pipeOutput;
-
-			if (isReady())
-			{
-				// Read data from pipe and make sure process has ended transmitting 
-				do
-				{
-					pipeOutput = readFromPipe(_pipeReadOut);
-					result.append(pipeOutput);
-
-					// Wait for process
-					std::this_thread::sleep_for(std::chrono::milliseconds(100));
-				} while (pipeOutput.length() > 0 && result.rfind(_endFlag) == std::string::npos);
-			}
-			else
-			{
-				// Connection is broken
-				throw carousel::exceptions::IpcCommunicationException("IpcPipeHandler::read - Communication to process is broken.");
-			}
-
-			return result;
-		}
 #pragma endregion
 
 #pragma region Private_helpers
@@ -99,8 +75,9 @@ namespace carousel
 			startup_info.dwFlags |= STARTF_USESTDHANDLES;
 
 			// prepare string
-			char* zt = new char[_pathToExe.length() + 1];
-			std::strcpy(zt, _pathToExe.c_str());
+			std::string commandLine = _parameters.empty() ? _pathToExe : _pathToExe + " " + _parameters;
+			char* zt = new char[commandLine.length() + 1];
+			std::strcpy(zt, commandLine.c_str());
 
 			// Try create new subprocess
 			bool bSuccess = CreateProcessA(NULL,
@@ -119,27 +96,35 @@ namespace carousel
 			if (bSuccess)
 			{
 				_processHandle = process_info.hProcess;
-				_processId = process_info.dwProcessId;
+				_processId = static_cast<int>(process_info.dwProcessId);
+				CloseHandle(process_info.hThread);
 
-				// Wait for process to finish initialization
-				std::string pipeData{ "" };
-				while (pipeData.length() == 0)
-				{
-					// wait for process
-					std::this_thread::sleep_for(std::chrono::milliseconds(_initProcTime));
-					pipeData = readFromPipe(_pipeReadOut);;
-				}
+				// Child ends are owned by the child now, closing them lets the reader see a broken pipe once the process exits
+				CloseHandle(_pipeWriteOut);
+				CloseHandle(_pipeReadIn);
+				_pipeWriteOut = NULL;
+				_pipeReadIn = NULL;
 
-				_processReady = true;
+				// Reader thread blocks on the out pipe, writer thread on the in pipe
+				_readerThread = std::thread(&IpcPipeHandler::readerLoop, this);
+				_writerThread = std::thread(&IpcPipeHandler::writerLoop, this);
+
+				// Wait for process to finish initialization
+				setProcessState(waitForInitialization());
 			}
 			else 
 			{
 				// Process did not initialize, clear handles
+				CloseHandle(_pipeWriteIn);
+				CloseHandle(_pipeReadOut);
+				CloseHandle(_pipeWriteOut);
+				CloseHandle(_pipeReadIn);
 				_pipeWriteIn = NULL;
 				_pipeReadOut = NULL;
 				_pipeWriteOut = NULL;
 				_pipeReadIn = NULL;
 				_processHandle = NULL;
+				setProcessState(false);
 			}
 
 			// cleanup
@@ -148,15 +133,51 @@ namespace carousel
 
 		void IpcPipeHandler::closeProcess()
 		{
+			_processReady = false;
+
+			// Force closing process, the reader thread sees a broken pipe once the process is gone
+			UINT uExitCode = -1;
+			if (_processHandle != NULL)
+			{
+				TerminateProcess(_processHandle, uExitCode);
+				WaitForSingleObject(_processHandle, 5000);
+			}
+
+			// Stop the reader thread, a read that is still blocked (e.g. the pipe is inherited by
+			// another process) is cancelled
+			if (_readerThread.joinable())
+			{
+				std::unique_lock<std::mutex> lock(_pipeMutex);
+				while (!_pipeClosed)
+				{
+					CancelSynchronousIo(_readerThread.native_handle());
+					_pipeChanged.wait_for(lock, std::chrono::milliseconds(10), [this]() { return _pipeClosed; });
+				}
+				lock.unlock();
+				_readerThread.join();
+			}
+
+			// Stop the writer thread, a write the process does not read anymore is cancelled
+			if (_writerThread.joinable())
+			{
+				std::unique_lock<std::mutex> lock(_writeMutex);
+				_writerStopping = true;
+				_writeChanged.notify_all();
+				while (!_writeData.empty())
+				{
+					CancelSynchronousIo(_writerThread.native_handle());
+					_writeChanged.wait_for(lock, std::chrono::milliseconds(10), [this]() { return _writeData.empty(); });
+				}
+				lock.unlock();
+				_writerThread.join();
+			}
+
 			// Close all other handles
 			CloseHandle(_pipeWriteIn);
 			CloseHandle(_pipeReadOut);
 			CloseHandle(_pipeWriteOut);
 			CloseHandle(_pipeReadIn);
-
-			// Force closing process
-			UINT uExitCode = -1;
-			TerminateProcess(_processHandle, uExitCode);
+			CloseHandle(_processHandle);
 
 			// set null
 			_pipeWriteIn = NULL;
@@ -174,41 +195,35 @@ namespace carousel
 			security_attrib.bInheritHandle = TRUE;
 			security_attrib.lpSecurityDescriptor = NULL;
 
-			CreatePipe(&_pipeReadIn, &_pipeWriteIn, &security_attrib, 0);
+			CreatePipe(&_pipeReadIn, &_pipeWriteIn, &security_attrib, BUFFER_SIZE);
 			SetHandleInformation(_pipeWriteIn, HANDLE_FLAG_INHERIT, 0);
 
-			CreatePipe(&_pipeReadOut, &_pipeWriteOut, &security_attrib, 0);
+			CreatePipe(&_pipeReadOut, &_pipeWriteOut, &security_attrib, BUFFER_SIZE);
 			SetHandleInformation(_pipeReadOut, HANDLE_FLAG_INHERIT, 0);
 		}
 #pragma endregion
 
 #pragma region Helpers
-		std::string IpcPipeHandler::readFromPipe(SystemHandle pipeReadOut)
+		size_t IpcPipeHandler::readFromPipe(SystemHandle pipeReadOut, IpcReceiveBuffer& buffer)
 		{
-			// Result
-			std::stringstream pipeData;
-
-			char buffer[BUFFER_SIZE];
-			memset(buffer, 0, sizeof(buffer));
-			DWORD bytesRead, bytesAvailable;
-
-			// While data is contained in the pipe, get data from the pipe.
-			// Note: PeekNamedPipe checks if data is available before calling the
-			//		 ReadFile method. This avoids a possible deadlock.
-			while (PeekNamedPipe(pipeReadOut, NULL, 0, NULL, &bytesAvailable, NULL) > 0)
-			{
-				if (bytesAvailable == 0) break;
-				bool readSuccess = ReadFile(pipeReadOut, buffer, sizeof(BUFFER_SIZE), &bytesRead, NULL);
-
-				if (!readSuccess || bytesRead == 0) break;
-				pipeData.write(buffer, bytesRead);
-			}
-
-			return pipeData.str();
+			// Data is collected by the reader thread, move everything received so far
+			std::lock_guard<std::mutex> lock(_pipeMutex);
+			size_t bytesRead = _pipeData.length();
+			buffer.write(_pipeData.data(), bytesRead);
+			_pipeData.clear();
+			if (!_pipeClosed) ResetEvent(_dataEvent);
+
+			return bytesRead;
 		}
 
 		void IpcPipeHandler::writeToPipe(const std::string& command, SystemHandle pipeWriteIn)
 		{
+			// Data of an asynchronous command is written first
+			{
+				std::unique_lock<std::mutex> lock(_writeMutex);
+				_writeChanged.wait(lock, [this]() { return _writeData.empty(); });
+			}
+
 			DWORD dwWritten;
 			BOOL bSuccess = FALSE;
 			size_t dataLen = command.length();
@@ -228,11 +243,115 @@ namespace carousel
 					NULL                              // Not overlapped
 				);
 
-				if (!bSuccess) break;
+				if (!bSuccess)
+				{
+					throw carousel::exceptions::IpcCommunicationException("IpcPipeHandler::writeToPipe - Write failed with error " + std::to_string(GetLastError()) + " (" + std::to_string(totalWritten) + " of " + std::to_string(dataLen) + " bytes written)");
+				}
 
 				totalWritten += dwWritten;
 			}
 		}
+
+		size_t IpcPipeHandler::writeAvailable(const char* data, size_t length, SystemHandle pipeWriteIn)
+		{
+			std::lock_guard<std::mutex> lock(_writeMutex);
+			if (_writeError != 0)
+			{
+				throw carousel::exceptions::IpcCommunicationException("IpcPipeHandler::writeAvailable - Write failed with error " + std::to_string(_writeError));
+			}
+
+			if (!_writerThread.joinable() || _writerStopping)
+			{
+				throw carousel::exceptions::IpcCommunicationException("IpcPipeHandler::writeAvailable - Communication to process is broken.");
+			}
+
+			// The writer thread takes the next data once it wrote the previous one
+			if (!_writeData.empty() || length == 0) return 0;
+
+			_writeData.assign(data, length);
+			ResetEvent(_writeEvent);
+			_writeChanged.notify_all();
+
+			return length;
+		}
+
+		SystemHandle IpcPipeHandler::notificationHandle() const
+		{
+			return _dataEvent;
+		}
+
+		SystemHandle IpcPipeHandler::writeNotificationHandle() const
+		{
+			return _writeEvent;
+		}
+
+		bool IpcPipeHandler::waitForData(int timeoutMs)
+		{
+			std::unique_lock<std::mutex> lock(_pipeMutex);
+			_pipeChanged.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() { return !_pipeData.empty() || _pipeClosed; });
+			_outputClosed = _pipeClosed && _pipeData.empty();
+
+			return !_pipeData.empty();
+		}
+
+		void IpcPipeHandler::readerLoop()
+		{
+			char buffer[BUFFER_SIZE];
+			DWORD bytesRead = 0;
+
+			// ReadFile blocks until the process writes, the pipe is broken or the read is cancelled
+			while (ReadFile(_pipeReadOut, buffer, sizeof(buffer), &bytesRead, NULL) && bytesRead > 0)
+			{
+				{
+					std::lock_guard<std::mutex> lock(_pipeMutex);
+					_pipeData.append(buffer, bytesRead);
+					SetEvent(_dataEvent);
+				}
+				_pipeChanged.notify_all();
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(_pipeMutex);
+				_pipeClosed = true;
+				SetEvent(_dataEvent);
+			}
+			_pipeChanged.notify_all();
+		}
+
+		void IpcPipeHandler::writerLoop()
+		{
+			std::unique_lock<std::mutex> lock(_writeMutex);
+			while (true)
+			{
+				_writeChanged.wait(lock, [this]() { return !_writeData.empty() || _writerStopping; });
+				if (_writeData.empty()) break;
+
+				// Data is not changed while it is written, writeAvailable only takes data while the thread is idle.
+				// WriteFile blocks until the process reads, the pipe is broken or the write is cancelled.
+				const char* data = _writeData.data();
+				size_t dataLen = _writeData.length();
+				lock.unlock();
+
+				size_t totalWritten = 0;
+				DWORD error = 0;
+				while (totalWritten < dataLen)
+				{
+					DWORD dwWritten;
+					if (!WriteFile(_pipeWriteIn, data + totalWritten, static_cast<DWORD>(min(BUFFER_SIZE, dataLen - totalWritten)), &dwWritten, NULL))
+					{
+						error = GetLastError();
+						break;
+					}
+					totalWritten += dwWritten;
+				}
+
+				lock.lock();
+				_writeData.clear();
+				if (error != 0) _writeError = error;
+				SetEvent(_writeEvent);
+				_writeChanged.notify_all();
+			}
+		}
 #pragma endregion
 	}
 }
\ No newline at end of file
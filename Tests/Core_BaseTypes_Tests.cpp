@@ -3,7 +3,10 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <sstream>
+#include <filesystem>
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <xercesc/dom/DOM.hpp>
 #include <xercesc/dom/DOMImplementation.hpp>
 #include <xercesc/util/XMLString.hpp>
@@ -11,6 +14,7 @@
 #include <stdlib.h>
 #include <charconv>
 #include "../Carousel/include/Core/BaseTypes/XmlSerializable.h"
+#include "../Carousel/include/Core/BaseTypes/XmlBulkLoader.h"
 #include "../Carousel/include/Helpers/Converters.h"
 
 
@@ -129,4 +133,351 @@ TEST_CASE("Core_Base_types", "[classic]")
 		// corresponds to another structure
 		REQUIRE_THROWS_AS(exampleIncorrectStructure.loadFromXml("SerializableTest.xml"), std::runtime_error);
 	}
+
+	SECTION("Serializable object - Save to stream and file")
+	{
+		// Initialize xerces which is used for serialization
+		xercesc::XMLPlatformUtils::Initialize();
+
+		SerializableTest example;
+		example.property1 = "Saved without intermediate copies";
+		example.property3 = 3030;
+
+		// Stream and string serialization produce the same content
+		std::ostringstream stream;
+		example.serialize(stream);
+		REQUIRE(stream.str() == example.serialize());
+
+		// Atomic save does not leave the temporary file behind
+		example.saveToXml("SerializableAtomicTest.xml", true);
+		REQUIRE(std::filesystem::exists("SerializableAtomicTest.xml"));
+
+		// Temporary files are also removed if the target can't be replaced
+		std::filesystem::create_directories("SerializableAtomicDirectory.xml/Content");
+		REQUIRE_THROWS(example.saveToXml("SerializableAtomicDirectory.xml", true));
+
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator("."))
+		{
+			std::string filename = entry.path().filename().string();
+			REQUIRE_FALSE((filename.rfind("SerializableAtomic", 0) == 0 && entry.path().extension() == ".tmp"));
+		}
+
+		SerializableTest example_loaded;
+		example_loaded.loadFromXml("SerializableAtomicTest.xml");
+		REQUIRE(example.property1 == example_loaded.property1);
+		REQUIRE(example.property3 == example_loaded.property3);
+	}
+
+	SECTION("Serializable object - Save only if modified")
+	{
+		// Initialize xerces which is used for serialization
+		xercesc::XMLPlatformUtils::Initialize();
+
+		SerializableTest example;
+		example.saveToXml("SerializableAutosaveTest.xml");
+		REQUIRE_FALSE(example.isModified());
+
+		// Nothing changed, save is skipped
+		REQUIRE_FALSE(example.saveToXmlIfModified("SerializableAutosaveTest.xml"));
+
+		// Changed property is detected and saved
+		example.property3 = 4040;
+		REQUIRE(example.isModified());
+		REQUIRE(example.saveToXmlIfModified("SerializableAutosaveTest.xml"));
+		REQUIRE_FALSE(example.isModified());
+
+		SerializableTest example_loaded;
+		example_loaded.loadFromXml("SerializableAutosaveTest.xml");
+		REQUIRE(example_loaded.property3 == 4040);
+		REQUIRE_FALSE(example_loaded.isModified());
+	}
+
+	SECTION("Serializable object - Streaming load")
+	{
+		// Initialize xerces which is used for serialization
+		xercesc::XMLPlatformUtils::Initialize();
+
+		SerializableTest example;
+		example.property1 = "Streamed value";
+		example.property3 = 2020;
+		example.property4 = 5E-3;
+		example.saveToXml("SerializableStreamTest.xml");
+
+		// Load without DOM
+		SerializableTest example_stream;
+		example_stream.loadFromXmlStream("SerializableStreamTest.xml");
+		REQUIRE(example.property1 == example_stream.property1);
+		REQUIRE(example.property2 == example_stream.property2);
+		REQUIRE(example.property3 == example_stream.property3);
+		REQUIRE(example.property4 == example_stream.property4);
+
+		// Incorrect structure
+		SerializableTestOther exampleIncorrectStructure;
+		REQUIRE_THROWS_AS(exampleIncorrectStructure.loadFromXmlStream("SerializableStreamTest.xml"), std::runtime_error);
+
+		// File with repeated objects, only some of them contain property2
+		std::ofstream resultSet("SerializableResultSet.xml");
+		resultSet << "<ResultSet>";
+		for (int i = 0; i < 100; i++)
+		{
+			resultSet << "<SearializableTest><property1>Entry</property1>";
+			if (i % 10 == 0) resultSet << "<property2>Custom</property2>";
+			resultSet << "<property3>" << i << "</property3></SearializableTest>";
+		}
+		resultSet << "</ResultSet>";
+		resultSet.close();
+
+		int sum{ 0 };
+		int customCount{ 0 };
+		size_t objectCount = carousel::core::XmlSerializable::loadAllFromXmlStream<SerializableTest>("SerializableResultSet.xml",
+			[&sum, &customCount](SerializableTest& entry)
+			{
+				sum += entry.property3;
+				if (entry.property2 == "Custom") customCount++;
+			});
+
+		REQUIRE(objectCount == 100);
+		REQUIRE(sum == 4950);
+
+		// Missing properties keep their default value, they are not taken from the previous element
+		REQUIRE(customCount == 10);
+	}
+
+	SECTION("Serializable object - Transcoding")
+	{
+		// Initialize xerces which is used for serialization
+		xercesc::XMLPlatformUtils::Initialize();
+
+		// Tag names are transcoded once and shared
+		const XMLCh* tagName = carousel::core::XmlTagNames::get("property1");
+		REQUIRE(tagName == carousel::core::XmlTagNames::get("property1"));
+		REQUIRE(carousel::core::XmlTranscoder::local().toString(tagName) == "property1");
+
+		// Buffers grow with the transcoded value
+		std::string longValue(5000, 'x');
+		carousel::core::XmlTranscoder& transcoder = carousel::core::XmlTranscoder::local();
+		REQUIRE(transcoder.toString(transcoder.toXml("short")) == "short");
+		REQUIRE(transcoder.toString(transcoder.toXml(longValue)) == longValue);
+		REQUIRE(transcoder.toString(transcoder.toXml("")).empty());
+	}
+
+	SECTION("Serializable object - Parallel bulk load")
+	{
+		// Initialize xerces which is used for serialization
+		xercesc::XMLPlatformUtils::Initialize();
+
+		std::filesystem::create_directories("BulkLoadTest");
+		for (int i = 0; i < 40; i++)
+		{
+			SerializableTest example;
+			example.property3 = i;
+			example.saveToXml("BulkLoadTest/Serializable" + std::to_string(100 + i) + ".xml");
+		}
+
+		std::ofstream broken("BulkLoadTest/Broken.xml");
+		broken << "<SearializableTest>";
+		broken.close();
+
+		carousel::core::XmlBulkLoader<SerializableTest> loader(4);
+		carousel::core::XmlBulkLoader<SerializableTest>::Result result = loader.loadDirectory("BulkLoadTest");
+
+		// Results are ordered by file name
+		REQUIRE(result.objects.size() == 40);
+		for (int i = 0; i < 40; i++)
+		{
+			REQUIRE(result.objects[i]->property3 == i);
+		}
+
+		REQUIRE(result.errors.size() == 1);
+		REQUIRE(std::filesystem::path(result.errors[0].filepath).filename() == "Broken.xml");
+		REQUIRE(result.errors[0].message.find("SAXParseException") != std::string::npos);
+		REQUIRE(result.errors[0].message.find("line 1") != std::string::npos);
+	}
+
+	SECTION("Serializable object - JSON")
+	{
+		// Initialize xerces which is used for serialization
+		xercesc::XMLPlatformUtils::Initialize();
+
+		SerializableTest example;
+		example.property1 = "Quoted \"value\"\nwith line break";
+		example.property3 = 3030;
+		example.property4 = 2.5E-7;
+
+		SerializableTest example_loaded;
+		example_loaded.loadFromJson(example.toJson());
+		REQUIRE(example.property1 == example_loaded.property1);
+		REQUIRE(example.property2 == example_loaded.property2);
+		REQUIRE(example.property3 == example_loaded.property3);
+		REQUIRE(example.property4 == example_loaded.property4);
+
+		// Loaded values are part of the next XML save
+		REQUIRE(example_loaded.isModified());
+
+		// Batches
+		std::vector<std::unique_ptr<SerializableTest>> batch;
+		for (int i = 0; i < 100; i++)
+		{
+			batch.push_back(std::make_unique<SerializableTest>());
+			batch.back()->property3 = i;
+		}
+
+		int sum{ 0 };
+		size_t objectCount = carousel::core::XmlSerializable::loadAllFromJson<SerializableTest>(carousel::core::XmlSerializable::toJsonArray(batch),
+			[&sum](SerializableTest& entry) { sum += entry.property3; });
+
+		REQUIRE(objectCount == 100);
+		REQUIRE(sum == 4950);
+
+		// Members missing in an element keep their default value, they are not taken from the previous element
+		std::vector<std::string> secondValues;
+		objectCount = carousel::core::XmlSerializable::loadAllFromJson<SerializableTest>("[{\"property2\": \"Custom\", \"property3\": \"1\"}, {\"property3\": \"2\"}]",
+			[&secondValues](SerializableTest& entry) { secondValues.push_back(entry.property2); });
+		REQUIRE(objectCount == 2);
+		REQUIRE(secondValues == std::vector<std::string>{ "Custom", "SecondValue" });
+
+		REQUIRE_THROWS_AS(example_loaded.loadFromJson("{\"property3\": {}}"), std::runtime_error);
+	}
+
+	SECTION("Serializable object - Compressed files")
+	{
+		// Initialize xerces which is used for serialization
+		xercesc::XMLPlatformUtils::Initialize();
+
+		SerializableTest example;
+		example.property1 = std::string(10000, 'a');
+		example.property3 = 5050;
+		example.saveToXml("SerializableCompressed.xml.gz", true);
+		example.saveToXml("SerializableUncompressed.xml");
+
+		REQUIRE(carousel::core::XmlCompression::isCompressed("SerializableCompressed.xml.gz"));
+		REQUIRE(std::filesystem::file_size("SerializableCompressed.xml.gz") * 10 < std::filesystem::file_size("SerializableUncompressed.xml"));
+
+		// Compression is detected on load
+		SerializableTest example_loaded;
+		example_loaded.loadFromXml("SerializableCompressed.xml.gz");
+		REQUIRE(example.property1 == example_loaded.property1);
+		REQUIRE(example.property3 == example_loaded.property3);
+
+		SerializableTest example_stream;
+		example_stream.loadFromXmlStream("SerializableCompressed.xml.gz");
+		REQUIRE(example.property3 == example_stream.property3);
+	}
+
+	SECTION("Serializable object - Property lookup")
+	{
+		// Initialize xerces which is used for serialization
+		xercesc::XMLPlatformUtils::Initialize();
+
+		// Properties in another order, unknown and empty properties
+		std::ofstream file("SerializableReordered.xml");
+		file << "<SearializableTest><property4>0.5</property4><unknown>1</unknown><property3>77</property3><property1/></SearializableTest>";
+		file.close();
+
+		SerializableTest example;
+		example.loadFromXml("SerializableReordered.xml");
+		REQUIRE(example.property4 == 0.5);
+		REQUIRE(example.property3 == 77);
+		REQUIRE(example.property1.empty());
+		REQUIRE(example.property2 == "SecondValue");
+
+		// Empty values are saved and loaded again
+		example.saveToXml("SerializableReordered.xml");
+		SerializableTest example_loaded;
+		example_loaded.loadFromXml("SerializableReordered.xml");
+		REQUIRE(example_loaded.property1.empty());
+		REQUIRE(example_loaded.property3 == 77);
+	}
+}
+
+TEST_CASE("Core_Base_types benchmark", "[!benchmark]")
+{
+	// Initialize xerces which is used for serialization
+	xercesc::XMLPlatformUtils::Initialize();
+
+	SerializableTest example;
+	example.saveToXml("SerializableBenchmark.xml");
+
+	BENCHMARK("loadFromXml - pooled parser")
+	{
+		SerializableTest loaded;
+		loaded.loadFromXml("SerializableBenchmark.xml");
+		return loaded.property3;
+	};
+
+	BENCHMARK("Parse - new parser per load")
+	{
+		// Previous behaviour, parser is created and destroyed for each load
+		xercesc::XercesDOMParser* parser = new xercesc::XercesDOMParser();
+		parser->setValidationScheme(xercesc::XercesDOMParser::Val_Never);
+		parser->setDoNamespaces(false);
+		parser->setDoSchema(false);
+		parser->setLoadExternalDTD(false);
+
+		XMLCh* filename = xercesc::XMLString::transcode("SerializableBenchmark.xml");
+		parser->parse(filename);
+		xercesc::XMLString::release(&filename);
+
+		bool hasDocument = parser->getDocument() != nullptr;
+		delete parser;
+		return hasDocument;
+	};
+
+	BENCHMARK("Serialize - XML")
+	{
+		return example.serialize();
+	};
+
+	BENCHMARK("Serialize - JSON")
+	{
+		return example.toJson();
+	};
+
+	std::string json = example.toJson();
+	BENCHMARK("loadFromJson")
+	{
+		SerializableTest loaded;
+		loaded.loadFromJson(json);
+		return loaded.property3;
+	};
+
+	// Large batches
+	std::vector<std::unique_ptr<SerializableTest>> batch;
+	for (int i = 0; i < 1000; i++)
+	{
+		batch.push_back(std::make_unique<SerializableTest>());
+		batch.back()->property3 = i;
+	}
+
+	BENCHMARK("Batch of 1000 - XML serialize")
+	{
+		size_t size{ 0 };
+		for (auto& entry : batch)
+		{
+			size += entry->serialize().size();
+		}
+		return size;
+	};
+
+	BENCHMARK("Batch of 1000 - JSON serialize")
+	{
+		return carousel::core::XmlSerializable::toJsonArray(batch).size();
+	};
+
+	std::string batchJson = carousel::core::XmlSerializable::toJsonArray(batch);
+	BENCHMARK("Batch of 1000 - JSON load")
+	{
+		return carousel::core::XmlSerializable::loadAllFromJson<SerializableTest>(batchJson, [](SerializableTest&) {});
+	};
+
+	BENCHMARK("Parse - pooled parser")
+	{
+		auto parser = carousel::core::XmlParserPool::instance().acquire();
+
+		XMLCh* filename = xercesc::XMLString::transcode("SerializableBenchmark.xml");
+		parser->parse(filename);
+		xercesc::XMLString::release(&filename);
+
+		return parser->getDocument() != nullptr;
+	};
 }
\ No newline at end of file
@@ -1,8 +1,13 @@
 #include <iostream>
 #include <fstream>
+#include <filesystem>
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include "../Carousel/include/Data/SharedTypes/carouselModels.h"
 #include "../Carousel/include/Data/Models/Project.h"
+#include "../Carousel/include/Data/Models/XmlModelLoader.h"
+#include "../Carousel/include/Data/Models/BinaryModels.h"
+#include "../Carousel/include/Data/Models/ProjectArchive.h"
 #include "../Carousel/include/Logging/CarouselLogger.h"
 
 
@@ -62,4 +67,165 @@ TEST_CASE("Carousel Data Models", "[classic]")
 		// Serialized Project
 		std::string serializedProject = project.serialize();
 	}
+
+	SECTION("Loading models with pooled parsers")
+	{
+		// Initialize xerces which is used for serialization
+		xercesc::XMLPlatformUtils::Initialize();
+
+		carousel::data::CaseModel caseModel;
+		caseModel.Id(12);
+		caseModel.Name("Pooled case");
+
+		xml_schema::namespace_infomap map;
+		map[""].name = "http://www.carousel.com/carousel/data";
+		std::ofstream ofs("PooledCaseModel.xml");
+		carousel::data::CaseModel_(ofs, caseModel, map);
+		ofs.close();
+
+		// Parsers are reused, each load builds a new model
+		for (int i = 0; i < 3; i++)
+		{
+			std::unique_ptr<carousel::data::CaseModel> loaded = carousel::data::XmlModelLoader::load("PooledCaseModel.xml", &carousel::data::CaseModel_);
+			REQUIRE(loaded->Id().get() == 12);
+			REQUIRE(loaded->Name().get() == "Pooled case");
+		}
+
+		REQUIRE_THROWS_AS(carousel::data::XmlModelLoader::load("MissingCaseModel.xml", &carousel::data::CaseModel_), std::runtime_error);
+	}
+
+	SECTION("Loading models from mapped files")
+	{
+		// Initialize xerces which is used for serialization
+		xercesc::XMLPlatformUtils::Initialize();
+
+		carousel::data::CaseModel caseModel;
+		caseModel.Id(21);
+		caseModel.Script(std::string(1 << 20, 'x'));
+
+		xml_schema::namespace_infomap map;
+		map[""].name = "http://www.carousel.com/carousel/data";
+		std::ofstream ofs("MappedCaseModel.xml");
+		carousel::data::CaseModel_(ofs, caseModel, map);
+		ofs.close();
+
+		// Generated InputSource overload
+		carousel::core::MappedFileInputSource source("MappedCaseModel.xml");
+		std::unique_ptr<carousel::data::CaseModel> loaded = carousel::data::CaseModel_(source, xml_schema::flags::dont_validate);
+		REQUIRE(loaded->Id().get() == 21);
+		REQUIRE(loaded->Script().get().size() == (1 << 20));
+
+		REQUIRE_THROWS_AS(carousel::core::MappedFileInputSource("MissingCaseModel.xml"), std::runtime_error);
+	}
+
+	SECTION("Binary serialization")
+	{
+		// Single model, missing attributes stay missing
+		carousel::data::CaseModel caseModel;
+		caseModel.Id(12);
+		caseModel.IDProject(-5);
+		caseModel.Name("Binary case");
+		caseModel.PosX(1.0 / 3.0);
+
+		carousel::data::CaseModel copy = carousel::data::fromBinary<carousel::data::CaseModel>(carousel::data::toBinary(caseModel));
+		REQUIRE(copy.Id().get() == 12);
+		REQUIRE(copy.IDProject().get() == -5);
+		REQUIRE(copy.Name().get() == "Binary case");
+		REQUIRE(copy.PosX().get() == 1.0 / 3.0);
+		REQUIRE_FALSE(copy.Script().present());
+
+		// Sequence of models
+		std::stringstream stream;
+		carousel::data::BinaryModelWriter<carousel::data::EquilibriumPhaseFractionModel> writer(stream);
+		for (int i = 0; i < 1000; i++)
+		{
+			carousel::data::EquilibriumPhaseFractionModel entry;
+			entry.Id(i);
+			entry.IDCase(3);
+			entry.Temperature(300.0 + i * 0.1);
+			entry.Value(i * 1E-3);
+			writer.write(entry);
+		}
+
+		carousel::data::BinaryModelReader<carousel::data::EquilibriumPhaseFractionModel> reader(stream);
+		std::vector<carousel::data::EquilibriumPhaseFractionModel> entries = reader.readAll();
+		REQUIRE(entries.size() == 1000);
+		REQUIRE(entries[999].Id().get() == 999);
+		REQUIRE(entries[10].Temperature().get() == 300.0 + 10 * 0.1);
+
+		// Wrong model type and truncated data
+		std::istringstream caseStream(carousel::data::toBinary(caseModel));
+		REQUIRE_THROWS_AS(carousel::data::BinaryModelReader<carousel::data::ProjectModel>(caseStream), carousel::exceptions::SerializationException);
+
+		std::string truncated = carousel::data::toBinary(caseModel);
+		truncated.resize(truncated.size() - 3);
+		REQUIRE_THROWS_AS(carousel::data::fromBinary<carousel::data::CaseModel>(truncated), carousel::exceptions::SerializationException);
+	}
+
+	SECTION("Project archive")
+	{
+		// Initialize xerces which is used for serialization
+		xercesc::XMLPlatformUtils::Initialize();
+
+		carousel::data::Project project{};
+		project.setId(7);
+		project.setName("Archived project");
+
+		std::ofstream configuration("ArchiveConfiguration.xml");
+		configuration << "<CarouselConfiguration/>";
+		configuration.close();
+
+		std::ofstream database("ArchiveDatabase.db", std::ios::binary);
+		database << std::string(4096, '\0');
+		database.close();
+
+		carousel::data::ProjectArchive::save("Project.carousel", project, "ArchiveConfiguration.xml", "ArchiveDatabase.db");
+
+		carousel::data::Project loaded{};
+		bool hasDatabase = carousel::data::ProjectArchive::load("Project.carousel", loaded, "RestoredConfiguration.xml", "RestoredDatabase.db");
+		REQUIRE(hasDatabase);
+		REQUIRE(loaded.getId() == 7);
+		REQUIRE(loaded.getName() == "Archived project");
+		REQUIRE(std::filesystem::file_size("RestoredConfiguration.xml") == std::filesystem::file_size("ArchiveConfiguration.xml"));
+		REQUIRE(std::filesystem::file_size("RestoredDatabase.db") == 4096);
+
+		// Database snapshot is optional
+		carousel::data::ProjectArchive::save("ProjectWithoutDatabase.carousel", project, "ArchiveConfiguration.xml");
+		REQUIRE_FALSE(carousel::data::ProjectArchive::load("ProjectWithoutDatabase.carousel", loaded, "RestoredConfiguration.xml"));
+	}
+}
+
+TEST_CASE("Carousel Data Models benchmark", "[!benchmark]")
+{
+	// Initialize xerces which is used for serialization
+	xercesc::XMLPlatformUtils::Initialize();
+
+	carousel::data::Project project{};
+	project.setName("Benchmark project");
+	project.saveToXml("ProjectBenchmark.xml");
+	std::string json = project.toJson();
+
+	BENCHMARK("Project - XML serialize")
+	{
+		return project.serialize();
+	};
+
+	BENCHMARK("Project - JSON serialize")
+	{
+		return project.toJson();
+	};
+
+	BENCHMARK("Project - XML load")
+	{
+		carousel::data::Project loaded{};
+		loaded.loadFromXml("ProjectBenchmark.xml");
+		return loaded.getId();
+	};
+
+	BENCHMARK("Project - JSON load")
+	{
+		carousel::data::Project loaded{};
+		loaded.loadFromJson(json);
+		return loaded.getId();
+	};
 }
\ No newline at end of file
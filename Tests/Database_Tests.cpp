@@ -6,6 +6,10 @@
 #include "../Carousel/include/Data/Database/Sqlite3Database.h"
 #include "../Carousel/include/Data/Database/DatabaseTable.h"
 #include "../Carousel/include/Data/Database/DatabaseAdapterManager.h"
+#include "../Carousel/include/Data/Database/LazyRelationship.h"
+#include "../Carousel/include/Data/Database/IdAllocator.h"
+#include "../Carousel/include/Data/Models/EquilibriumSummary.h"
+#include "../Carousel/include/Data/Models/PrecipitationSummary.h"
 #include "../Carousel/include/Logging/CarouselLogger.h"
 #include "../Carousel/include/Helpers/Converters.h"
 
@@ -221,6 +225,360 @@ public: // IDatabaseObject implementation
 	}
 };
 
+/// <summary>
+/// Mock object used for testing data that depends on ProjectMock (Foreign key IDProject)
+/// </summary>
+class CaseMock : public carousel::data::IDatabaseObject
+{
+private:
+	/// <summary>
+	/// Base model data
+	/// </summary>
+	carousel::data::CaseModel _model{};
+
+public:
+	/// <summary>
+	/// Constructor
+	/// </summary>
+	CaseMock() : carousel::data::IDatabaseObject()
+	{
+		// Default values
+		_model.Id().set(-1);
+		_model.IDProject().set(-1);
+		_model.Name().set("Case name");
+	}
+
+public:
+	/// <summary>
+	/// Get Id
+	/// </summary>
+	/// <returns></returns>
+	const int& getId() { return _model.Id().get(); }
+
+	/// <summary>
+	/// Set Id
+	/// </summary>
+	/// <param name="newValue"></param>
+	void setId(const int& newValue) { _model.Id().set(newValue); }
+
+	/// <summary>
+	/// Get project Id
+	/// </summary>
+	/// <returns></returns>
+	const int& getIDProject() { return _model.IDProject().get(); }
+
+	/// <summary>
+	/// Set project Id
+	/// </summary>
+	/// <param name="newValue"></param>
+	void setIDProject(const int& newValue) { _model.IDProject().set(newValue); }
+
+	/// <summary>
+	/// Get name
+	/// </summary>
+	/// <returns></returns>
+	const std::string& getName() { return _model.Name().get(); }
+
+	/// <summary>
+	/// Set name
+	/// </summary>
+	/// <param name="newName"></param>
+	void setName(const std::string& newName) { _model.Name().set(newName); }
+
+public: // IDatabaseObject implementation
+
+	virtual int load(std::vector<std::string>& rawData) override
+	{
+		setId(-1);
+		if (rawData.size() < get_table_structure().size()) return 1;
+		setId(carousel::helpers::converters::convertFromString<int>(rawData[0]));
+		setIDProject(carousel::helpers::converters::convertFromString<int>(rawData[1]));
+		setName(rawData[2]);
+
+		return 0;
+	}
+
+	virtual carousel::data::DatabaseTable& get_table_structure() override
+	{
+		static carousel::data::DatabaseTable table("Case");
+		static bool initialized = false;
+
+		if (!initialized)
+		{
+			table.addColumn("Id", typeid(int).name(), &CaseMock::getId, &CaseMock::setId, carousel::data::DatabaseConstraintType::PRIMARY_KEY);
+			table.addForeignKey("IDProject", typeid(int).name(), &CaseMock::getIDProject, &CaseMock::setIDProject, "Project");
+			table.addColumn("Name", typeid(std::string).name(), &CaseMock::getName, &CaseMock::setName, carousel::data::DatabaseConstraintType::COLUMN);
+			initialized = true;
+		}
+
+		return table;
+	}
+};
+
+/// <summary>
+/// Mock object used for testing summaries of result data (Foreign key IDCase)
+/// </summary>
+class EquilibriumPhaseFractionMock : public carousel::data::IDatabaseObject
+{
+private:
+	/// <summary>
+	/// Base model data
+	/// </summary>
+	carousel::data::EquilibriumPhaseFractionModel _model{};
+
+public:
+	/// <summary>
+	/// Constructor
+	/// </summary>
+	EquilibriumPhaseFractionMock() : carousel::data::IDatabaseObject()
+	{
+		// Default values
+		_model.Id().set(-1);
+		_model.IDCase().set(-1);
+		_model.Temperature().set(0.0);
+		_model.Value().set(0.0);
+	}
+
+public:
+	/// <summary>
+	/// Get Id
+	/// </summary>
+	/// <returns></returns>
+	const int& getId() { return _model.Id().get(); }
+
+	/// <summary>
+	/// Set Id
+	/// </summary>
+	/// <param name="newValue"></param>
+	void setId(const int& newValue) { _model.Id().set(newValue); }
+
+	/// <summary>
+	/// Get case Id
+	/// </summary>
+	/// <returns></returns>
+	const int& getIDCase() { return _model.IDCase().get(); }
+
+	/// <summary>
+	/// Set case Id
+	/// </summary>
+	/// <param name="newValue"></param>
+	void setIDCase(const int& newValue) { _model.IDCase().set(newValue); }
+
+	/// <summary>
+	/// Get temperature
+	/// </summary>
+	/// <returns></returns>
+	const double& getTemperature() { return _model.Temperature().get(); }
+
+	/// <summary>
+	/// Set temperature
+	/// </summary>
+	/// <param name="newValue"></param>
+	void setTemperature(const double& newValue) { _model.Temperature().set(newValue); }
+
+	/// <summary>
+	/// Get phase fraction
+	/// </summary>
+	/// <returns></returns>
+	const double& getValue() { return _model.Value().get(); }
+
+	/// <summary>
+	/// Set phase fraction
+	/// </summary>
+	/// <param name="newValue"></param>
+	void setValue(const double& newValue) { _model.Value().set(newValue); }
+
+public: // IDatabaseObject implementation
+
+	virtual int load(std::vector<std::string>& rawData) override
+	{
+		setId(-1);
+		if (rawData.size() < get_table_structure().size()) return 1;
+		setId(std::stoi(rawData[0]));
+		setIDCase(std::stoi(rawData[1]));
+		setTemperature(std::stod(rawData[2]));
+		setValue(std::stod(rawData[3]));
+
+		return 0;
+	}
+
+	virtual carousel::data::DatabaseTable& get_table_structure() override
+	{
+		static carousel::data::DatabaseTable table("EquilibriumPhaseFraction");
+		static bool initialized = false;
+
+		if (!initialized)
+		{
+			table.addColumn("Id", typeid(int).name(), &EquilibriumPhaseFractionMock::getId, &EquilibriumPhaseFractionMock::setId, carousel::data::DatabaseConstraintType::PRIMARY_KEY);
+			table.addForeignKey("IDCase", typeid(int).name(), &EquilibriumPhaseFractionMock::getIDCase, &EquilibriumPhaseFractionMock::setIDCase, "Case");
+			table.addColumn("Temperature", typeid(double).name(), &EquilibriumPhaseFractionMock::getTemperature, &EquilibriumPhaseFractionMock::setTemperature, carousel::data::DatabaseConstraintType::COLUMN);
+			table.addColumn("Value", typeid(double).name(), &EquilibriumPhaseFractionMock::getValue, &EquilibriumPhaseFractionMock::setValue, carousel::data::DatabaseConstraintType::COLUMN);
+			initialized = true;
+		}
+
+		return table;
+	}
+};
+
+/// <summary>
+/// Mock object used for testing summaries of precipitation results
+/// </summary>
+class PrecipitationSimulationDataMock : public carousel::data::IDatabaseObject
+{
+private:
+	/// <summary>
+	/// Base model data
+	/// </summary>
+	carousel::data::PrecipitationSimulationDataModel _model{};
+
+public:
+	/// <summary>
+	/// Constructor
+	/// </summary>
+	PrecipitationSimulationDataMock() : carousel::data::IDatabaseObject()
+	{
+		// Default values
+		_model.Id().set(-1);
+		_model.IDPrecipitationPhase().set(-1);
+		_model.IDHeatTreatment().set(-1);
+		_model.Time().set(0.0);
+		_model.PhaseFraction().set(0.0);
+		_model.MeanRadius().set(0.0);
+	}
+
+public:
+	/// <summary>
+	/// Get Id
+	/// </summary>
+	/// <returns></returns>
+	const int& getId() { return _model.Id().get(); }
+
+	/// <summary>
+	/// Set Id
+	/// </summary>
+	/// <param name="newValue"></param>
+	void setId(const int& newValue) { _model.Id().set(newValue); }
+
+	/// <summary>
+	/// Get precipitation phase Id
+	/// </summary>
+	/// <returns></returns>
+	const int& getIDPrecipitationPhase() { return _model.IDPrecipitationPhase().get(); }
+
+	/// <summary>
+	/// Set precipitation phase Id
+	/// </summary>
+	/// <param name="newValue"></param>
+	void setIDPrecipitationPhase(const int& newValue) { _model.IDPrecipitationPhase().set(newValue); }
+
+	/// <summary>
+	/// Get heat treatment Id
+	/// </summary>
+	/// <returns></returns>
+	const int& getIDHeatTreatment() { return _model.IDHeatTreatment().get(); }
+
+	/// <summary>
+	/// Set heat treatment Id
+	/// </summary>
+	/// <param name="newValue"></param>
+	void setIDHeatTreatment(const int& newValue) { _model.IDHeatTreatment().set(newValue); }
+
+	/// <summary>
+	/// Get time
+	/// </summary>
+	/// <returns></returns>
+	const double& getTime() { return _model.Time().get(); }
+
+	/// <summary>
+	/// Set time
+	/// </summary>
+	/// <param name="newValue"></param>
+	void setTime(const double& newValue) { _model.Time().set(newValue); }
+
+	/// <summary>
+	/// Get phase fraction
+	/// </summary>
+	/// <returns></returns>
+	const double& getPhaseFraction() { return _model.PhaseFraction().get(); }
+
+	/// <summary>
+	/// Set phase fraction
+	/// </summary>
+	/// <param name="newValue"></param>
+	void setPhaseFraction(const double& newValue) { _model.PhaseFraction().set(newValue); }
+
+	/// <summary>
+	/// Get mean radius
+	/// </summary>
+	/// <returns></returns>
+	const double& getMeanRadius() { return _model.MeanRadius().get(); }
+
+	/// <summary>
+	/// Set mean radius
+	/// </summary>
+	/// <param name="newValue"></param>
+	void setMeanRadius(const double& newValue) { _model.MeanRadius().set(newValue); }
+
+public: // IDatabaseObject implementation
+
+	virtual int load(std::vector<std::string>& rawData) override
+	{
+		setId(-1);
+		if (rawData.size() < get_table_structure().size()) return 1;
+		setId(std::stoi(rawData[0]));
+		setIDPrecipitationPhase(std::stoi(rawData[1]));
+		setIDHeatTreatment(std::stoi(rawData[2]));
+		setTime(std::stod(rawData[3]));
+		setPhaseFraction(std::stod(rawData[4]));
+		setMeanRadius(std::stod(rawData[5]));
+
+		return 0;
+	}
+
+	virtual carousel::data::DatabaseTable& get_table_structure() override
+	{
+		static carousel::data::DatabaseTable table("PrecipitationSimulationData");
+		static bool initialized = false;
+
+		if (!initialized)
+		{
+			table.addColumn("Id", typeid(int).name(), &PrecipitationSimulationDataMock::getId, &PrecipitationSimulationDataMock::setId, carousel::data::DatabaseConstraintType::PRIMARY_KEY);
+			table.addForeignKey("IDPrecipitationPhase", typeid(int).name(), &PrecipitationSimulationDataMock::getIDPrecipitationPhase, &PrecipitationSimulationDataMock::setIDPrecipitationPhase, "PrecipitationPhase");
+			table.addForeignKey("IDHeatTreatment", typeid(int).name(), &PrecipitationSimulationDataMock::getIDHeatTreatment, &PrecipitationSimulationDataMock::setIDHeatTreatment, "HeatTreatment");
+			table.addColumn("Time", typeid(double).name(), &PrecipitationSimulationDataMock::getTime, &PrecipitationSimulationDataMock::setTime, carousel::data::DatabaseConstraintType::COLUMN);
+			table.addColumn("PhaseFraction", typeid(double).name(), &PrecipitationSimulationDataMock::getPhaseFraction, &PrecipitationSimulationDataMock::setPhaseFraction, carousel::data::DatabaseConstraintType::COLUMN);
+			table.addColumn("MeanRadius", typeid(double).name(), &PrecipitationSimulationDataMock::getMeanRadius, &PrecipitationSimulationDataMock::setMeanRadius, carousel::data::DatabaseConstraintType::COLUMN);
+			initialized = true;
+		}
+
+		return table;
+	}
+};
+
+/// <summary>
+/// Returns the number of entries contained in a table, used for checking database operations
+/// </summary>
+int countEntries(const carousel::data::DatabaseConfiguration& configuration, const std::string& tableName)
+{
+	sqlite3* db{ nullptr };
+	sqlite3_stmt* stmt{ nullptr };
+	int count{ -1 };
+
+	std::string databaseFilename = configuration.databaseDirectory + "\\" + configuration.databaseFileName;
+	if (sqlite3_open(databaseFilename.c_str(), &db) == SQLITE_OK)
+	{
+		std::string query = "SELECT COUNT(*) FROM '" + tableName + "'";
+		if (sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, 0) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW)
+		{
+			count = sqlite3_column_int(stmt, 0);
+		}
+		sqlite3_finalize(stmt);
+	}
+
+	sqlite3_close(db);
+	return count;
+}
+
 #pragma endregion
 
 
@@ -331,6 +689,231 @@ TEST_CASE("DatabaseAdapterManager Tests")
 		db.save(&projectWithUniqueConstraint);
 	}
 
+	SECTION("Remove DatabaseObject with dependent data")
+	{
+		// Parent and dependent tables
+		ProjectMock project;
+		CaseMock caseMock;
+		db.createTable(&project.get_table_structure());
+		db.createTable(&caseMock.get_table_structure());
+
+		// Project with dependent cases
+		project.setName("Project with cases");
+		db.save(&project);
+		REQUIRE(project.getId() > -1);
+
+		int casesBefore = countEntries(databaseConfiguration, caseMock.get_table_structure().getTableName());
+		for (size_t i = 0; i < 10; i++)
+		{
+			CaseMock dependentCase;
+			dependentCase.setIDProject(project.getId());
+			dependentCase.setName("Case " + std::to_string(i));
+			db.save(&dependentCase);
+		}
+		REQUIRE(countEntries(databaseConfiguration, caseMock.get_table_structure().getTableName()) == casesBefore + 10);
+
+		// Removing the project removes all cases that reference it
+		int projectsBefore = countEntries(databaseConfiguration, project.get_table_structure().getTableName());
+		db.remove(&project);
+		REQUIRE(project.getId() == carousel::data::DEFAULT_ID);
+		REQUIRE(countEntries(databaseConfiguration, project.get_table_structure().getTableName()) == projectsBefore - 1);
+		REQUIRE(countEntries(databaseConfiguration, caseMock.get_table_structure().getTableName()) == casesBefore);
+	}
+
+	SECTION("Lazy loading of dependent data")
+	{
+		// Parent and dependent tables
+		ProjectMock firstProject, secondProject;
+		db.createTable(&firstProject.get_table_structure());
+		db.createTable(&CaseMock().get_table_structure());
+		db.save(&firstProject);
+		db.save(&secondProject);
+
+		// Each project contains three cases
+		for (auto* project : { &firstProject, &secondProject })
+		{
+			for (size_t i = 0; i < 3; i++)
+			{
+				CaseMock dependentCase;
+				dependentCase.setIDProject(project->getId());
+				db.save(&dependentCase);
+			}
+		}
+
+		// Batch size of two loads both projects at once, budget of four objects
+		// allows keeping only one project in memory.
+		carousel::data::LazyRelationship<CaseMock> cases(db, "IDProject", 2, 4);
+		cases.registerParent(firstProject.getId());
+		cases.registerParent(secondProject.getId());
+
+		carousel::data::LazyCollection<CaseMock> firstCases(cases, [&] { return firstProject.getId(); });
+		carousel::data::LazyCollection<CaseMock> secondCases(cases, [&] { return secondProject.getId(); });
+		REQUIRE_FALSE(firstCases.isLoaded());
+
+		// First access loads the batch and releases the least recently used collection
+		auto loadedCases = firstCases.get();
+		REQUIRE(loadedCases->size() == 3);
+		REQUIRE(loadedCases->front()->getIDProject() == firstProject.getId());
+		REQUIRE(firstCases.isLoaded());
+		REQUIRE_FALSE(secondCases.isLoaded());
+		REQUIRE(cases.loadedCount() == 3);
+
+		// Accessing the second project releases the first one
+		REQUIRE(secondCases.get()->size() == 3);
+		REQUIRE_FALSE(firstCases.isLoaded());
+		REQUIRE(cases.loadedCount() == 3);
+
+		// Released collections are still valid for the caller
+		REQUIRE(loadedCases->size() == 3);
+	}
+
+	SECTION("Save object graph with pre-allocated primary keys")
+	{
+		ProjectMock project;
+		db.createTable(&project.get_table_structure());
+		db.createTable(&CaseMock().get_table_structure());
+
+		// Build the object graph in memory, children reference the parent before it is saved
+		carousel::data::IdAllocator allocator(db, 10);
+		int projectId = allocator.assignId(&project);
+		REQUIRE(projectId > 0);
+
+		std::vector<CaseMock> cases(5);
+		std::vector<carousel::data::IDatabaseObject*> graph{ &project };
+		for (auto& dependentCase : cases)
+		{
+			dependentCase.setIDProject(project.getId());
+			allocator.assignId(&dependentCase);
+			graph.push_back(&dependentCase);
+		}
+		REQUIRE(cases.back().getId() == cases.front().getId() + 4);
+
+		// Save graph in a single batch, keys are kept
+		db.save(graph);
+		REQUIRE(project.getId() == projectId);
+		REQUIRE(db.getRawData(&project.get_table_structure(), "Id", { projectId }).size() == 1);
+		REQUIRE(db.getRawData(&CaseMock().get_table_structure(), "IDProject", { projectId }).size() == 5);
+
+		// Objects saved without pre-allocated keys do not collide with the reserved range
+		ProjectMock otherProject;
+		db.save(&otherProject);
+		REQUIRE(otherProject.getId() >= projectId + 10);
+	}
+
+	SECTION("Summary tables")
+	{
+		CaseMock summarizedCase;
+		EquilibriumPhaseFractionMock phaseFraction;
+		carousel::data::EquilibriumSummary summary;
+		db.createTable(&summarizedCase.get_table_structure());
+		db.createTable(&phaseFraction.get_table_structure());
+		db.createSummaryTables();
+		db.save(&summarizedCase);
+
+		// Phase is stable up to 800 degrees
+		std::vector<EquilibriumPhaseFractionMock> results(8);
+		std::vector<carousel::data::IDatabaseObject*> resultObjects;
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			results[i].setIDCase(summarizedCase.getId());
+			results[i].setTemperature(300.0 + 100.0 * i);
+			results[i].setValue(i < 6 ? 0.1 : 0.0);
+			resultObjects.push_back(&results[i]);
+		}
+		db.save(resultObjects);
+
+		// Summary is maintained while inserting
+		auto rawSummary = db.getRawData(&summary.get_table_structure(), "IDCase", { summarizedCase.getId() });
+		REQUIRE(rawSummary.size() == 1);
+		REQUIRE(summary.load(rawSummary[0]) == 0);
+		REQUIRE(summary.getSolvusTemperature() == 800.0);
+
+		// Rebuild gives the same result
+		db.rebuildSummaryTables();
+		rawSummary = db.getRawData(&summary.get_table_structure(), "IDCase", { summarizedCase.getId() });
+		REQUIRE(rawSummary.size() == 1);
+		REQUIRE(summary.load(rawSummary[0]) == 0);
+		REQUIRE(summary.getSolvusTemperature() == 800.0);
+
+		// Summary is removed together with the case
+		int caseId = summarizedCase.getId();
+		db.remove(&summarizedCase);
+		REQUIRE(db.getRawData(&summary.get_table_structure(), "IDCase", { caseId }).empty());
+	}
+
+	SECTION("Precipitation summary tables")
+	{
+		PrecipitationSimulationDataMock resultRow;
+		carousel::data::PrecipitationSummary summary;
+		carousel::data::DatabaseTable& resultTable = resultRow.get_table_structure();
+		db.createTable(&resultTable);
+		db.createSummaryTables();
+
+		// Results of previous test runs, their summary is removed with them
+		const int heatTreatmentId{ 1 };
+		std::vector<int> previousIds;
+		for (auto& row : db.getRawData(&resultTable, "IDHeatTreatment", { heatTreatmentId }))
+		{
+			previousIds.push_back(std::stoi(row[0]));
+		}
+		db.remove(&resultTable, previousIds);
+		REQUIRE(db.getRawData(&summary.get_table_structure(), "IDHeatTreatment", { heatTreatmentId }).empty());
+
+		// Time steps are not saved in order, the last time step is not the last row
+		std::vector<double> times{ 10.0, 30.0, 20.0 };
+		std::vector<double> phaseFractions{ 0.25, 0.5, 0.75 };
+		std::vector<double> meanRadii{ 1.0, 3.0, 2.0 };
+		std::vector<PrecipitationSimulationDataMock> results(times.size());
+		std::vector<carousel::data::IDatabaseObject*> resultObjects;
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			results[i].setIDPrecipitationPhase(1);
+			results[i].setIDHeatTreatment(heatTreatmentId);
+			results[i].setTime(times[i]);
+			results[i].setPhaseFraction(phaseFractions[i]);
+			results[i].setMeanRadius(meanRadii[i]);
+			resultObjects.push_back(&results[i]);
+		}
+		db.save(resultObjects);
+
+		auto loadSummary = [&]()
+		{
+			auto rawSummary = db.getRawData(&summary.get_table_structure(), "IDHeatTreatment", { heatTreatmentId });
+			REQUIRE(rawSummary.size() == 1);
+			REQUIRE(summary.load(rawSummary[0]) == 0);
+		};
+
+		// Summary is maintained while inserting, mean radius is taken from the last time step
+		loadSummary();
+		REQUIRE(summary.getFinalTime() == 30.0);
+		REQUIRE(summary.getFinalMeanRadius() == 3.0);
+		REQUIRE(summary.getPeakPhaseFraction() == 0.75);
+
+		// Rebuild gives the same result
+		db.rebuildSummaryTables();
+		loadSummary();
+		REQUIRE(summary.getFinalTime() == 30.0);
+		REQUIRE(summary.getFinalMeanRadius() == 3.0);
+		REQUIRE(summary.getPeakPhaseFraction() == 0.75);
+
+		// Summary is maintained while updating
+		results[1].setMeanRadius(4.0);
+		db.save(&results[1]);
+		loadSummary();
+		REQUIRE(summary.getFinalMeanRadius() == 4.0);
+
+		// Summary is maintained while removing the last time step and the peak phase fraction
+		db.remove(&resultTable, { results[1].getId(), results[2].getId() });
+		loadSummary();
+		REQUIRE(summary.getFinalTime() == 10.0);
+		REQUIRE(summary.getFinalMeanRadius() == 1.0);
+		REQUIRE(summary.getPeakPhaseFraction() == 0.25);
+
+		// Summary is removed together with the results
+		db.remove(&resultTable, { results[0].getId() });
+		REQUIRE(db.getRawData(&summary.get_table_structure(), "IDHeatTreatment", { heatTreatmentId }).empty());
+	}
+
 	// cleanup
 	db.disconnect();
 }
\ No newline at end of file
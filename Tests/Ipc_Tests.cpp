@@ -3,17 +3,50 @@
 #include <catch2/catch_test_macros.hpp>
 #include "../Carousel/include/IpcTools/IpcPipeHandler.h"
 #include "../Carousel/include/Exceptions/IpcCommunicationException.h"
+#include "../Carousel/include/IpcTools/IpcReceiveBuffer.h"
+#include "../Carousel/include/IpcTools/IpcProcessPool.h"
+#include "../Carousel/include/IpcTools/IpcWarmPool.h"
+#include "../Carousel/include/IpcTools/IpcDispatcher.h"
+#include "../Carousel/include/IpcTools/IpcOutputParser.h"
+#include "../Carousel/include/IpcTools/IpcResultRows.h"
+#include <thread>
+#include <chrono>
+
+#ifdef __unix__
+#include "../Carousel/include/IpcTools/IpcSharedMemory.h"
+#include "../Carousel/include/IpcTools/IpcSharedMemoryApi.h"
+#include "../Carousel/include/IpcTools/IpcSharedMemoryLayout.h"
+#include <cerrno>
+#endif
+
+namespace
+{
+#ifdef _WIN32
+	/// <summary>
+	/// Console mock executable
+	/// </summary>
+	const std::string CONSOLE_MOCK = "./ConsoleMock.exe MC:";
+
+	/// <summary>
+	/// Line ending written by the console mock
+	/// </summary>
+	const std::string LINE_END = "\r\n";
+#else
+	const std::string CONSOLE_MOCK = "./ConsoleMock MC:";
+	const std::string LINE_END = "\n";
+#endif
+}
 
 
 TEST_CASE("Ipc", "[classic]")
 {
 	SECTION("Ipc communication")
 	{
-		carousel::ipcTools::IpcPipeHandler newIpc("./ConsoleMock.exe MC:", "MC: ", "MC:", 30);
+		carousel::ipcTools::IpcPipeHandler newIpc(CONSOLE_MOCK, "MC:" + LINE_END, "", 30);
 		//carousel::ipcTools::IpcPipeHandler newIpc("C:\\Program Files\\MatCalc 6\\mcc.exe", "MC: ", "", 10);
 
 		std::string pipeData;
-		std::string flag = " MC:\r\n";
+		std::string flag = " MC:" + LINE_END;
 
 		// ConsoleMock is waiting for input, reading should not block and return and empty string
 		pipeData = newIpc.read();
@@ -24,18 +57,502 @@ TEST_CASE("Ipc", "[classic]")
 
 		// Short command
 		newIpc.send("Invalid content\n");
-		std::this_thread::sleep_for(std::chrono::milliseconds(100));
 		pipeData = newIpc.read();
 		REQUIRE(pipeData == "Invalid content" + flag);
 
 		// Long command
 		std::string lorem = "Sed ut perspiciatis unde omnis iste natus error sit voluptatem accusantium doloremque laudantium, totam rem aperiam, eaque ipsa quae ab illo inventore veritatis et quasi architecto beatae vitae dicta sunt explicabo.Nemo enim ipsam voluptatem quia voluptas sit aspernatur aut odit aut fugit, sed quia consequuntur magni dolores eos qui ratione voluptatem sequi nesciunt.Neque porro quisquam est, qui dolorem ipsum quia dolor sit amet, consectetur, adipisci velit, sed quia non numquam eius modi tempora incidunt ut labore et dolore magnam aliquam quaerat voluptatem.Ut enim ad minima veniam, quis nostrum exercitationem ullam corporis suscipit laboriosam, nisi ut aliquid ex ea commodi consequatur ? Quis autem vel eum iure reprehenderit qui in ea voluptate velit esse quam nihil molestiae consequatur, vel illum qui dolorem eum fugiat quo voluptas nulla pariatur ?";
 		newIpc.send(lorem + "\n");
-		std::this_thread::sleep_for(std::chrono::milliseconds(100));
 		pipeData = newIpc.read();
 		REQUIRE(pipeData == lorem + flag);
 	}
 
+	SECTION("Ipc reads return on end flag")
+	{
+		carousel::ipcTools::IpcPipeHandler newIpc(CONSOLE_MOCK, "MC:" + LINE_END, "", 30);
+
+		// Responses are returned as soon as the end flag arrives, no polling delay per command
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < 200; i++)
+		{
+			std::string command = "Command " + std::to_string(i);
+			newIpc.send(command + "\n");
+			REQUIRE(newIpc.read() == command + " MC:" + LINE_END);
+		}
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+		REQUIRE(elapsed.count() < 5000);
+	}
+
+	SECTION("Ipc responses are read one at a time")
+	{
+		carousel::ipcTools::IpcPipeHandler newIpc(CONSOLE_MOCK, "MC:" + LINE_END, "", 30);
+
+		// Both responses arrive before the first read, the second one is kept for the next read
+		newIpc.send("First\n");
+		newIpc.send("Second\n");
+		REQUIRE(newIpc.read() == "First MC:" + LINE_END);
+		REQUIRE(newIpc.read() == "Second MC:" + LINE_END);
+	}
+
+	SECTION("Ipc pipelined batch")
+	{
+		carousel::ipcTools::IpcPipeHandler newIpc(CONSOLE_MOCK, "MC:" + LINE_END, "", 30);
+
+		// Sweep, responses are demultiplexed in command order
+		std::vector<std::string> commands;
+		for (int i = 0; i < 500; i++)
+		{
+			commands.push_back("Temperature " + std::to_string(500 + i) + "\n");
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		auto result = newIpc.sendBatch(commands);
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+		REQUIRE(result.succeeded());
+		REQUIRE(result.responses.size() == 500);
+		for (int i = 0; i < 500; i++)
+		{
+			REQUIRE(result.responses[i] == "Temperature " + std::to_string(500 + i) + " MC:" + LINE_END);
+		}
+		REQUIRE(elapsed.count() < 5000);
+
+		// Commands larger than the pipe buffer in total are throttled, a window of one is a plain round trip
+		std::string large(8 * 1024, 'x');
+		auto throttled = newIpc.sendBatch(std::vector<std::string>(40, large + "\n"), 100);
+		REQUIRE(throttled.succeeded());
+		REQUIRE(throttled.responses.size() == 40);
+		REQUIRE(throttled.responses[39] == large + " MC:" + LINE_END);
+		REQUIRE(newIpc.sendBatch({ "One\n", "Two\n" }, 1).responses[1] == "Two MC:" + LINE_END);
+
+		// Synchronous commands still work after a batch
+		newIpc.send("After batch\n");
+		REQUIRE(newIpc.read() == "After batch MC:" + LINE_END);
+
+		// The batch stops at the command that breaks the process, completed responses are kept
+		auto failed = newIpc.sendBatch({ "First\n", "exit\n", "Never answered\n" });
+		REQUIRE_FALSE(failed.succeeded());
+		REQUIRE(failed.responses.size() == 2);
+		REQUIRE(failed.responses[0] == "First MC:" + LINE_END);
+		REQUIRE(failed.responses[1] == "exit MC:" + LINE_END);
+
+		// A batch that times out terminates the process, no late response is handed to a later command
+		carousel::ipcTools::IpcPipeHandler stalled(CONSOLE_MOCK, "MC:" + LINE_END, "", 1);
+		auto timedOut = stalled.sendBatch({ "First\n", "No line end", "Joined\n", "Never answered" });
+		REQUIRE_FALSE(timedOut.succeeded());
+		REQUIRE(timedOut.responses.size() == 2);
+		REQUIRE(timedOut.responses[1] == "No line endJoined MC:" + LINE_END);
+		REQUIRE_FALSE(stalled.isReady());
+		REQUIRE_THROWS_AS(stalled.send("After timeout\n"), carousel::exceptions::IpcCommunicationException);
+		REQUIRE_THROWS_AS(stalled.read(), carousel::exceptions::IpcCommunicationException);
+	}
+
+	SECTION("Ipc output parser")
+	{
+		struct Row
+		{
+			int idCase{ 0 };
+			double temperature{ 0.0 };
+			double value{ 0.0 };
+		};
+
+		std::vector<Row> rows;
+		std::vector<double> progress;
+
+		carousel::ipcTools::IpcOutputFormat format;
+		format.progressPrefix = "Progress:";
+		format.tablePrefix = "Phase fraction";
+		format.progressInterval = std::chrono::hours(1);
+
+		carousel::ipcTools::IpcRowEmitter<Row> emitter(Row{ 7 },
+			{
+				[](Row& row, double value) { row.temperature = value; },
+				[](Row& row, double value) { row.value = value; }
+			},
+			[&rows](const Row& row) { rows.push_back(row); });
+
+		carousel::ipcTools::IpcOutputParser parser(format, emitter, [&progress](const std::string&, double value) { progress.push_back(value); });
+
+		// Fed byte by byte, rows are only read inside the table, progress is throttled
+		std::string output = "Loading 3 databases\r\nProgress: 10 %\nProgress: 20 %\nPhase fraction FCC_A1\n 500.0\t0.25\n600.0  1e-1\n\n700;0.05\nT = 800 K\n900 0.5\nProgress: 100 %\nMC:";
+		for (char c : output)
+		{
+			parser.feed(&c, 1);
+		}
+		REQUIRE(rows.size() == 3);
+		REQUIRE(progress == std::vector<double>{ 10.0 });
+
+		parser.finish();
+		REQUIRE(progress == std::vector<double>{ 10.0, 100.0 });
+		REQUIRE(rows[0].idCase == 7);
+		REQUIRE(rows[0].temperature == 500.0);
+		REQUIRE(rows[1].value == 0.1);
+		REQUIRE(rows[2].temperature == 700.0);
+		REQUIRE(parser.rowCount() == 3);
+
+		// The table ends with the output of the command
+		parser.feed("1000 0.9\n");
+		REQUIRE(rows.size() == 3);
+
+		// Rows converted into data models
+		std::vector<carousel::data::EquilibriumPhaseFractionModel> phaseFractions;
+		carousel::ipcTools::IpcRowEmitter<carousel::data::EquilibriumPhaseFractionModel> modelEmitter = carousel::ipcTools::equilibriumPhaseFractionRows(12,
+			[&phaseFractions](const carousel::data::EquilibriumPhaseFractionModel& row) { phaseFractions.push_back(row); }, "Phase fraction");
+		carousel::ipcTools::IpcOutputParser modelParser(format, modelEmitter);
+		modelParser.feed("Phase fraction BCC_A2\n1200 0.75\n1300\t0.5\nMC:");
+		modelParser.finish();
+
+		REQUIRE(phaseFractions.size() == 2);
+		REQUIRE(phaseFractions[0].IDCase().get() == 12);
+		REQUIRE(phaseFractions[0].Temperature().get() == 1200.0);
+		REQUIRE(phaseFractions[0].Value().get() == 0.75);
+		REQUIRE(phaseFractions[1].IDCase().get() == 12);
+		REQUIRE(phaseFractions[1].Temperature().get() == 1300.0);
+		REQUIRE(phaseFractions[1].Value().get() == 0.5);
+
+		// Streamed from the process
+		carousel::ipcTools::IpcPipeHandler newIpc(CONSOLE_MOCK, "MC:" + LINE_END, "", 30);
+		std::string response;
+		newIpc.send("Progress: 50\n");
+		REQUIRE(newIpc.readStream([&](const std::string& piece) { response += piece; parser.feed(piece); }));
+		parser.finish();
+		REQUIRE(response == "Progress: 50 MC:" + LINE_END);
+		REQUIRE(progress.back() == 50.0);
+
+		// Pieces are handed out before the end flag arrives
+		carousel::ipcTools::IpcReceiveBuffer buffer("MC:\n", 16);
+		buffer.write("Row 1\nRow 2 MC", 14);
+		REQUIRE(buffer.popPartial() == "Row 1\nRow 2 ");
+		buffer.write(":\nNext", 6);
+		REQUIRE(buffer.popPartial() == "");
+		REQUIRE(buffer.popMessage() == "MC:\n");
+		REQUIRE(buffer.popPartial() == "Next");
+	}
+
+#ifdef __unix__
+	SECTION("Ipc shared memory")
+	{
+		carousel::ipcTools::IpcSharedMemory results(4096, 5);
+		REQUIRE(results.isReady());
+
+		// Only one writer can connect
+		carousel_shm_writer* writer = carousel_shm_open_writer(results.name().c_str());
+		REQUIRE(writer != nullptr);
+		REQUIRE(carousel_shm_open_writer(results.name().c_str()) == nullptr);
+		REQUIRE(carousel_shm_max_record(writer) == 2048 - 8);
+
+		// Nothing written yet
+		REQUIRE_FALSE(results.readRecord([](const char*, size_t) {}, 10));
+
+		// Rows of different lengths written in place, many times the ring size so the writer waits for space
+		std::thread solver([writer]()
+			{
+				for (int i = 0; i < 20000; i++)
+				{
+					size_t columns = 1 + i % 7;
+					double* row = static_cast<double*>(carousel_shm_reserve(writer, columns * sizeof(double), 5000));
+					if (!row) break;
+
+					for (size_t c = 0; c < columns; c++)
+					{
+						row[c] = i + 0.25 * c;
+					}
+					carousel_shm_commit(writer, columns * sizeof(double));
+				}
+
+				std::string last = "Done";
+				carousel_shm_write(writer, last.data(), last.length(), 5000);
+				carousel_shm_close_writer(writer);
+			});
+
+		int rows = 0;
+		bool consistent = true;
+		while (results.readRecord([&](const char* data, size_t length)
+			{
+				if (rows == 20000) return;
+
+				size_t columns = 1 + rows % 7;
+				const double* row = reinterpret_cast<const double*>(data);
+				consistent = consistent && length == columns * sizeof(double) && row[0] == rows && row[columns - 1] == rows + 0.25 * (columns - 1);
+				rows++;
+			}, 5000) && rows < 20000);
+		REQUIRE(rows == 20000);
+		REQUIRE(consistent);
+
+		REQUIRE(results.read() == "Done");
+		solver.join();
+
+		// All records read and the writer closed
+		REQUIRE(results.read() == "");
+		REQUIRE_FALSE(results.isReady());
+
+		// Records larger than half the ring are refused, writing fails once the reader is gone
+		auto reader = std::make_unique<carousel::ipcTools::IpcSharedMemory>(4096, 5);
+		writer = carousel_shm_open_writer(reader->name().c_str());
+		std::string record(1024, 'x');
+		REQUIRE(carousel_shm_write(writer, record.data(), 4096, 0) == -1);
+		REQUIRE(errno == EMSGSIZE);
+		REQUIRE(carousel_shm_write(writer, record.data(), record.length(), 0) == 0);
+		REQUIRE(carousel_shm_write(writer, record.data(), record.length(), 0) == 0);
+		REQUIRE(carousel_shm_write(writer, record.data(), record.length(), 0) == 0);
+		REQUIRE(carousel_shm_write(writer, record.data(), record.length(), 0) == -1);
+		REQUIRE(errno == ETIMEDOUT);
+		reader.reset();
+		REQUIRE(carousel_shm_write(writer, record.data(), record.length(), 1000) == -1);
+		REQUIRE(errno == EPIPE);
+		carousel_shm_close_writer(writer);
+
+		// Solver wrapper written in C, linked only against CarouselShm
+		carousel::ipcTools::IpcSharedMemory wrapperResults(64 * 1024, 5);
+		carousel::ipcTools::IpcPipeHandler wrapper("./ShmWriterMock", "MC:" + LINE_END, wrapperResults.name() + " 1000 MC:", 5);
+		REQUIRE(wrapper.isReady());
+		int wrapperRows = 0;
+		bool wrapperConsistent = true;
+		while (wrapperResults.readRecord([&](const char* data, size_t length)
+			{
+				const double* row = reinterpret_cast<const double*>(data);
+				wrapperConsistent = wrapperConsistent && length == 4 * sizeof(double) && row[0] == wrapperRows && row[3] == 0.25 * wrapperRows;
+				wrapperRows++;
+			}, 5000));
+		REQUIRE(wrapperRows == 1000);
+		REQUIRE(wrapperConsistent);
+		REQUIRE(wrapperResults.isFinished());
+
+		// Record lengths written by the other process are checked before the record is read
+		reader = std::make_unique<carousel::ipcTools::IpcSharedMemory>(4096, 5);
+		writer = carousel_shm_open_writer(reader->name().c_str());
+		void* payload = carousel_shm_reserve(writer, 16, 0);
+		REQUIRE(carousel_shm_commit(writer, 16) == 0);
+		reinterpret_cast<carousel::ipcTools::sharedMemory::RecordHeader*>(payload)[-1].length = 1 << 20;
+		REQUIRE_THROWS_AS(reader->read(), carousel::exceptions::IpcCommunicationException);
+		carousel_shm_close_writer(writer);
+	}
+#endif
+
+	SECTION("Ipc receive buffer")
+	{
+		// End flag split across chunks
+		carousel::ipcTools::IpcReceiveBuffer buffer("MC:\n", 16);
+		buffer.write("abc M", 5);
+		REQUIRE_FALSE(buffer.hasMessage());
+		buffer.write("C", 1);
+		buffer.write(":\nde", 4);
+		REQUIRE(buffer.messageCount() == 1);
+		REQUIRE(buffer.popMessage() == "abc MC:\n");
+		REQUIRE_FALSE(buffer.hasMessage());
+		REQUIRE(buffer.popAll() == "de");
+
+		// Partial matches that overlap the end flag
+		carousel::ipcTools::IpcReceiveBuffer overlapping("aab", 16);
+		overlapping.write("xaaaab", 6);
+		REQUIRE(overlapping.popMessage() == "xaaaab");
+
+		// Messages wrap around without growing the buffer
+		for (int i = 0; i < 1000; i++)
+		{
+			std::string message = std::to_string(i) + " MC:\n";
+			buffer.write(message.data(), message.length());
+			REQUIRE(buffer.popMessage() == message);
+		}
+		REQUIRE(buffer.capacity() == 16);
+
+		// Messages larger than the buffer make it grow
+		std::string chunk(4096, 'x');
+		for (int i = 0; i < 1024; i++)
+		{
+			buffer.write(chunk.data(), chunk.length());
+		}
+		buffer.write("MC:\n", 4);
+		std::string large = buffer.popMessage();
+		REQUIRE(large.length() == 4096 * 1024 + 4);
+		REQUIRE(large.substr(large.length() - 8) == "xxxxMC:\n");
+		REQUIRE(buffer.size() == 0);
+	}
+
+	SECTION("Ipc process pool")
+	{
+		carousel::ipcTools::IpcProcessPool pool(CONSOLE_MOCK, "MC:" + LINE_END, "", 4, 30);
+		REQUIRE(pool.workerCount() == 4);
+
+		// Scripts are distributed over the workers, responses are returned per script
+		std::vector<carousel::ipcTools::IpcProcessPool::Script> scripts;
+		for (int i = 0; i < 40; i++)
+		{
+			scripts.push_back({ "Case " + std::to_string(i) + "\n", "Done " + std::to_string(i) + "\n" });
+		}
+
+		auto results = pool.run(scripts);
+		REQUIRE(results.size() == 40);
+		for (int i = 0; i < 40; i++)
+		{
+			REQUIRE(results[i].size() == 2);
+			REQUIRE(results[i][0] == "Case " + std::to_string(i) + " MC:" + LINE_END);
+			REQUIRE(results[i][1] == "Done " + std::to_string(i) + " MC:" + LINE_END);
+		}
+
+		// A script that breaks the process fails, the worker restarts its process
+		auto failed = pool.submit({ "exit\n", "After exit\n" }, 1);
+		REQUIRE_THROWS_AS(failed.get(), carousel::exceptions::IpcCommunicationException);
+
+		auto restarted = pool.submit({ "After restart\n" }, 1);
+		REQUIRE(restarted.get()[0] == "After restart MC:" + LINE_END);
+	}
+
+	SECTION("Ipc warm pool")
+	{
+		carousel::ipcTools::IpcWarmPool pool(CONSOLE_MOCK, "MC:" + LINE_END, "", 2, 30);
+		carousel::ipcTools::IpcWarmProfile profile{ "thermo.tdb|physical.pdb|mobility.ddb", { "Load databases\n" }, { "Reset\n" } };
+
+		REQUIRE(pool.prewarm(profile, 2) == 2);
+		REQUIRE(pool.idleCount(profile.name) == 2);
+
+		// Warm processes are handed out without starting a new process
+		carousel::ipcTools::IpcPipeHandler* reused = nullptr;
+		{
+			auto start = std::chrono::steady_clock::now();
+			auto lease = pool.acquire(profile);
+			REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(100));
+			REQUIRE(pool.idleCount(profile.name) == 1);
+
+			lease->send("Equilibrium\n");
+			REQUIRE(lease->read() == "Equilibrium MC:" + LINE_END);
+			reused = &*lease;
+		}
+
+		// Released processes are reset and reused
+		REQUIRE(pool.idleCount(profile.name) == 2);
+		{
+			auto first = pool.acquire(profile);
+			REQUIRE(&*first == reused);
+			REQUIRE(first->isReady());
+
+			// Discarded processes are not returned
+			first.discard();
+		}
+		REQUIRE(pool.idleCount(profile.name) == 1);
+
+		// Processes with unread responses are not returned, the next job gets its own responses
+		{
+			auto unread = pool.acquire(profile);
+			unread->send("Not read\n");
+		}
+		REQUIRE(pool.idleCount(profile.name) == 0);
+		{
+			auto next = pool.acquire(profile);
+			next->send("Next job\n");
+			REQUIRE(next->read() == "Next job MC:" + LINE_END);
+		}
+		REQUIRE(pool.idleCount(profile.name) == 1);
+
+		// Other profiles start their own processes
+		REQUIRE(pool.idleCount("Other") == 0);
+	}
+
+	SECTION("Ipc asynchronous commands")
+	{
+		// Many sessions are driven by the dispatcher thread
+		std::vector<std::unique_ptr<carousel::ipcTools::IpcPipeHandler>> sessions;
+		std::vector<std::future<std::string>> responses;
+		for (int i = 0; i < 4; i++)
+		{
+			sessions.push_back(std::make_unique<carousel::ipcTools::IpcPipeHandler>(CONSOLE_MOCK, "MC:" + LINE_END, "", 30));
+		}
+
+		for (int command = 0; command < 10; command++)
+		{
+			for (auto& session : sessions)
+			{
+				responses.push_back(session->sendAsync("Command " + std::to_string(command) + "\n"));
+			}
+		}
+
+		for (size_t i = 0; i < responses.size(); i++)
+		{
+			REQUIRE(responses[i].get() == "Command " + std::to_string(i / sessions.size()) + " MC:" + LINE_END);
+		}
+
+		// Once its commands completed the session is released, synchronous reads get their responses right away
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < 5; i++)
+		{
+			sessions[3]->send("Synchronous " + std::to_string(i) + "\n");
+			REQUIRE(sessions[3]->read() == "Synchronous " + std::to_string(i) + " MC:" + LINE_END);
+			REQUIRE(sessions[3]->sendAsync("Asynchronous " + std::to_string(i) + "\n").get() == "Asynchronous " + std::to_string(i) + " MC:" + LINE_END);
+		}
+		REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+		REQUIRE(carousel::ipcTools::IpcDispatcher::instance().pendingCount() == 0);
+
+#ifdef __unix__
+		// A process that stops reading its input only stalls its own session, commands that can't be
+		// written completely are bound to their deadline and cancellation as well
+		carousel::ipcTools::IpcPipeHandler notReading("sh", "MC:" + LINE_END, "-c \"echo MC:; exec sleep 20\"", 10);
+		carousel::ipcTools::IpcPipeHandler notReadingCancelled("sh", "MC:" + LINE_END, "-c \"echo MC:; exec sleep 20\"", 10);
+		REQUIRE(notReading.isReady());
+		std::string largeCommand(1024 * 1024, 'x');
+		start = std::chrono::steady_clock::now();
+		auto blocked = notReading.sendAsync(largeCommand + "\n", std::chrono::milliseconds(200));
+		auto blockedCancellation = std::make_shared<carousel::ipcTools::IpcCancellation>();
+		auto blockedCancelled = notReadingCancelled.sendAsync(largeCommand + "\n", std::chrono::seconds(30), blockedCancellation);
+
+		REQUIRE(sessions[3]->sendAsync("Not blocked\n", std::chrono::milliseconds(500)).get() == "Not blocked MC:" + LINE_END);
+		REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(500));
+		REQUIRE_THROWS_AS(blocked.get(), carousel::exceptions::IpcCommunicationException);
+		REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(2));
+		REQUIRE_FALSE(notReading.isReady());
+
+		REQUIRE(blockedCancelled.wait_for(std::chrono::milliseconds(50)) == std::future_status::timeout);
+		blockedCancellation->cancel();
+		REQUIRE_THROWS_AS(blockedCancelled.get(), carousel::exceptions::IpcCommunicationException);
+		REQUIRE_FALSE(notReadingCancelled.isReady());
+#endif
+
+		// A command without line end is never answered, the process is terminated at the deadline
+		auto hung = sessions[0]->sendAsync("No line end", std::chrono::milliseconds(200));
+		auto queued = sessions[0]->sendAsync("Queued\n");
+		REQUIRE_THROWS_AS(hung.get(), carousel::exceptions::IpcCommunicationException);
+		REQUIRE_THROWS_AS(queued.get(), carousel::exceptions::IpcCommunicationException);
+		REQUIRE_FALSE(sessions[0]->isReady());
+
+		// Cancelling a queued command only removes that command
+		auto runningCancellation = std::make_shared<carousel::ipcTools::IpcCancellation>();
+		auto queuedCancellation = std::make_shared<carousel::ipcTools::IpcCancellation>();
+		auto running = sessions[1]->sendAsync("No line end", std::chrono::seconds(30), runningCancellation);
+		auto cancelled = sessions[1]->sendAsync("Cancelled\n", std::chrono::seconds(30), queuedCancellation);
+
+		queuedCancellation->cancel();
+		REQUIRE_THROWS_AS(cancelled.get(), carousel::exceptions::IpcCommunicationException);
+		REQUIRE(running.wait_for(std::chrono::milliseconds(50)) == std::future_status::timeout);
+
+		// Cancelling the running command terminates the process
+		runningCancellation->cancel();
+		REQUIRE_THROWS_AS(running.get(), carousel::exceptions::IpcCommunicationException);
+		REQUIRE_FALSE(sessions[1]->isReady());
+
+		// Destroying a session fails its pending commands
+		auto pending = sessions[2]->sendAsync("No line end");
+		sessions[2].reset();
+		REQUIRE_THROWS_AS(pending.get(), carousel::exceptions::IpcCommunicationException);
+		REQUIRE(sessions[3]->sendAsync("Still working\n").get() == "Still working MC:" + LINE_END);
+	}
+
+	SECTION("Ipc process that exits")
+	{
+		carousel::ipcTools::IpcPipeHandler newIpc(CONSOLE_MOCK, "MC: ", "", 30);
+
+		// ConsoleMock echoes the command and exits
+		newIpc.send("exit\n");
+
+		// Process is gone, communication is broken
+		for (int i = 0; i < 50 && newIpc.isReady(); i++)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		}
+		REQUIRE_FALSE(newIpc.isReady());
+		REQUIRE_THROWS_AS(newIpc.read(), carousel::exceptions::IpcCommunicationException);
+
+		// Writing to the closed input fails instead of being lost
+		REQUIRE_THROWS_AS(newIpc.send("After exit\n"), carousel::exceptions::IpcCommunicationException);
+	}
+
 	SECTION("Ipc process that can't be initialized")
 	{
 		try
@@ -51,4 +568,4 @@ TEST_CASE("Ipc", "[classic]")
 		}
 
 	}
-}
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+/*
+ * Solver wrapper mock written in C, it only links the CarouselShm writer helper (no C++ runtime).
+ * Usage: ShmWriterMock <shared memory name> <rows> <end flag>
+ * Writes the rows into the shared memory, prints the end flag and waits until its input is closed.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "../../Carousel/include/IpcTools/IpcSharedMemoryApi.h"
+
+int main(int argc, char* argv[])
+{
+	carousel_shm_writer* writer;
+	int rows;
+	int i;
+
+	if (argc < 4) return 2;
+
+	writer = carousel_shm_open_writer(argv[1]);
+	if (!writer)
+	{
+		printf("Could not connect to %s %s\n", argv[1], argv[3]);
+		fflush(stdout);
+		return 1;
+	}
+
+	/* Rows of time, phase fraction, number density and mean radius */
+	rows = atoi(argv[2]);
+	for (i = 0; i < rows; i++)
+	{
+		double* row = (double*)carousel_shm_reserve(writer, 4 * sizeof(double), 5000);
+		if (!row) break;
+
+		row[0] = i;
+		row[1] = 0.5 * i;
+		row[2] = 2.0 * i;
+		row[3] = 0.25 * i;
+		carousel_shm_commit(writer, 4 * sizeof(double));
+	}
+	carousel_shm_close_writer(writer);
+
+	printf("Wrote %d rows %s\n", i, argv[3]);
+	fflush(stdout);
+
+	while (getchar() != EOF);
+	return 0;
+}
\ No newline at end of file